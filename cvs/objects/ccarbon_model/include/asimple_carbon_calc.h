@@ -174,6 +174,25 @@ protected:
     //! expensive operations during calc.
     precalc_sigmoid_type precalc_sigmoid_diff;
     
+    // Similarly share the precalc soil carbon decay kernel between instances that
+    // have the same soil time scale.
+    struct precalc_soil_decay_helper {
+        precalc_soil_decay_helper( const int aSoilTimeScale );
+        std::vector<double> mData;
+        
+        const double& operator[]( const size_t aPos ) const {
+            return mData[ aPos ];
+        }
+    };
+    using precalc_soil_decay_type = boost::flyweights::flyweight<
+        boost::flyweights::key_value<int, precalc_soil_decay_helper>,
+        boost::flyweights::no_tracking>;
+    
+    //! The fraction of a soil carbon change which is emitted in each year offset
+    //! from the year of the change.  This value gets precomputed whenever the soil
+    //! time scale is set to avoid evaluating the exponential decay during calc.
+    precalc_soil_decay_type precalc_soil_decay_diff;
+    
     //! Flag to ensure historical emissions are only calculated a single time
     //! since they can not be reset.
     bool mHasCalculatedHistoricEmiss;
@@ -190,6 +209,12 @@ protected:
                                         const int aYear,
                                         const int aEndYear,
                                         objects::YearVector<double>& aEmissVector);
+
+    void addCurrEmissionsToTotal( const objects::YearVector<double>& aCurrEmissionsAbove,
+                                  const objects::YearVector<double>& aCurrEmissionsBelow,
+                                  const double aScale,
+                                  const int aStartYear,
+                                  const int aEndYear );
 private:
     void calcSigmoidCurve( const double aCarbonDiff,
                            const int aYear,
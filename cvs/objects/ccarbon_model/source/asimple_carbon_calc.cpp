@@ -67,6 +67,7 @@ mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEnd
     mLandUseHistory = 0;
     mLandLeaf = 0;
     mSoilTimeScale = CarbonModelUtils::getSoilTimeScale();
+    precalc_soil_decay_diff = precalc_soil_decay_type( mSoilTimeScale );
     mHasCalculatedHistoricEmiss = false;
 }
 
@@ -163,19 +164,11 @@ double ASimpleCarbonCalc::calc( const int aPeriod, const int aEndYear, const Car
         
         if( aCalcMode == eStoreResults ) {
             // add current emissions to the total
-            for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                mTotalEmissionsAbove[ year ] += currEmissionsAbove[ year ];
-                mTotalEmissionsBelow[ year ] += currEmissionsBelow[ year ];
-                mTotalEmissions[ year ] = mTotalEmissionsAbove[ year ] + mTotalEmissionsBelow[ year ];
-            }
+            addCurrEmissionsToTotal( currEmissionsAbove, currEmissionsBelow, 1.0, prevModelYear + 1, aEndYear );
         }
         else if( aCalcMode == eReverseCalc ) {
             // back out the current emissions from the total
-            for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                mTotalEmissionsAbove[ year ] -= currEmissionsAbove[ year ];
-                mTotalEmissionsBelow[ year ] -= currEmissionsBelow[ year ];
-                mTotalEmissions[ year ] = mTotalEmissionsAbove[ year ] + mTotalEmissionsBelow[ year ];
-            }
+            addCurrEmissionsToTotal( currEmissionsAbove, currEmissionsBelow, -1.0, prevModelYear + 1, aEndYear );
         }
         else if( aCalcMode == eReturnTotal ) {
             // Since the flag to avoid storing the full emissions is set we will just calculate
@@ -280,18 +273,13 @@ void ASimpleCarbonCalc::calcBelowGroundCarbonEmission( const double aCarbonDiff,
     // have occured, at twice the half-life 75% would have occurred, etc.
     // Note also that the aCarbonDiff is passed here as previous carbon minus current carbon
     // so a positive difference means that emissions will occur and a negative means uptake.
-    
-    const double halfLife = mSoilTimeScale / 10.0;
-    const double log2 = log( 2.0 );
-    const double lambda = log2 / halfLife;
-    int yearCounter = 0;
-    double cumStockDiff_t1, cumStockDiff_t2;
-    cumStockDiff_t1 = 0.0;
-    for( int currYear = aYear; currYear <= aEndYear; ++currYear ) {
-        yearCounter += 1;
-        cumStockDiff_t2 = aCarbonDiff * ( 1.0 - exp( -1.0 * lambda * yearCounter ) );
-        aEmissVector[ currYear ] += cumStockDiff_t2 - cumStockDiff_t1;
-        cumStockDiff_t1 = cumStockDiff_t2;
+    // To avoid expensive calculations the annual fraction of the change that occurs has
+    // already been precomputed so we simply need to scale it into the emissions.
+    const double* decayDiff = &precalc_soil_decay_diff.get().mData[ 0 ];
+    const int numYears = aEndYear - aYear + 1;
+    double* emiss = numYears > 0 ? &aEmissVector[ aYear ] : 0;
+    for( int i = 0; i < numYears; ++i ) {
+        emiss[ i ] += decayDiff[ i ] * aCarbonDiff;
     }
 }
 
@@ -315,10 +303,44 @@ void ASimpleCarbonCalc::calcSigmoidCurve( const double aCarbonDiff,
      */
     assert( getMatureAge() > 1 );
     
-    for( int currYear = aYear; currYear <= aEndYear; ++currYear ){
-        // To avoid expensive calculations the difference in the sigmoid curve
-        // has already been precomputed.
-        aEmissVector[ currYear ] += precalc_sigmoid_diff.get()[ currYear - aYear ] * aCarbonDiff;
+    // To avoid expensive calculations the difference in the sigmoid curve
+    // has already been precomputed.
+    const double* sigmoidDiff = &precalc_sigmoid_diff.get().mData[ 0 ];
+    const int numYears = aEndYear - aYear + 1;
+    double* emiss = numYears > 0 ? &aEmissVector[ aYear ] : 0;
+    for( int i = 0; i < numYears; ++i ) {
+        emiss[ i ] += sigmoidDiff[ i ] * aCarbonDiff;
+    }
+}
+
+/*!
+ * \brief Add the emissions calculated for the current time-step into the totals.
+ * \param aCurrEmissionsAbove The above ground emissions of the current time-step.
+ * \param aCurrEmissionsBelow The below ground emissions of the current time-step.
+ * \param aScale The scale to apply to the current emissions, 1 to add them or -1
+ *               to back them out of the totals.
+ * \param aStartYear The first year to accumulate.
+ * \param aEndYear The last year to accumulate.
+ */
+void ASimpleCarbonCalc::addCurrEmissionsToTotal( const YearVector<double>& aCurrEmissionsAbove,
+                                                 const YearVector<double>& aCurrEmissionsBelow,
+                                                 const double aScale,
+                                                 const int aStartYear,
+                                                 const int aEndYear )
+{
+    if( aStartYear > aEndYear ) {
+        return;
+    }
+    const double* currAbove = &aCurrEmissionsAbove[ aStartYear ];
+    const double* currBelow = &aCurrEmissionsBelow[ aStartYear ];
+    double* totalAbove = &mTotalEmissionsAbove[ aStartYear ];
+    double* totalBelow = &mTotalEmissionsBelow[ aStartYear ];
+    double* total = &mTotalEmissions[ aStartYear ];
+    const int numYears = aEndYear - aStartYear + 1;
+    for( int i = 0; i < numYears; ++i ) {
+        totalAbove[ i ] += aScale * currAbove[ i ];
+        totalBelow[ i ] += aScale * currBelow[ i ];
+        total[ i ] = totalAbove[ i ] + totalBelow[ i ];
     }
 }
 
@@ -392,6 +414,29 @@ double ASimpleCarbonCalc::getAboveGroundCarbonSubsidyDiscountFactor( ){
 
 void ASimpleCarbonCalc::setSoilTimeScale( const int aTimeScale ) {
     mSoilTimeScale = aTimeScale;
+    precalc_soil_decay_diff = precalc_soil_decay_type( mSoilTimeScale );
+}
+
+/*!
+ * \brief The boost fly weight will only actually construct one helper for each unique
+ *        soil time scale.  Any other time will just get the shared instance.
+ * \details The entry at each year offset is the fraction of a soil carbon change which
+ *          occurs during that year given an exponential decay with a half-life of the
+ *          soil time scale divided by ten.
+ */
+ASimpleCarbonCalc::precalc_soil_decay_helper::precalc_soil_decay_helper( const int aSoilTimeScale ):
+mData( CarbonModelUtils::getEndYear() - CarbonModelUtils::getStartYear() + 1 )
+{
+    const double halfLife = aSoilTimeScale / 10.0;
+    const double lambda = log( 2.0 ) / halfLife;
+    // Note the remaining fraction at offset zero is set explicitly to avoid
+    // 0 * inf when the soil time scale is zero.
+    double prevRemaining = 1.0;
+    for( size_t i = 0; i < mData.size(); ++i ) {
+        double currRemaining = exp( -1.0 * lambda * ( i + 1 ) );
+        mData[ i ] = prevRemaining - currRemaining;
+        prevRemaining = currRemaining;
+    }
 }
 
 double ASimpleCarbonCalc::getAboveGroundCarbonStock( const int aYear ) const {
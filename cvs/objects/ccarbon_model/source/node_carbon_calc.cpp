@@ -475,20 +475,12 @@ void NodeCarbonCalc::calc( const int aPeriod, const int aEndYear, const ICarbonC
         // add current emissions to the total
         for( size_t i = 0; i < mCarbonCalcs.size(); ++i ) {
             if( aCalcMode == ICarbonCalc::eStoreResults ) {
-                for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                    mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] += (*currEmissionsAbove[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ] += (*currEmissionsBelow[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissions[ year ] = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] +
-                        mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ];
-                }
+                mCarbonCalcs[ i ]->addCurrEmissionsToTotal( *currEmissionsAbove[ i ], *currEmissionsBelow[ i ],
+                                                            1.0, prevModelYear + 1, aEndYear );
             }
             else if( aCalcMode == ICarbonCalc::eReverseCalc ) {
-                for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
-                    mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] -= (*currEmissionsAbove[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ] -= (*currEmissionsBelow[ i ])[ year ];
-                    mCarbonCalcs[ i ]->mTotalEmissions[ year ] = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ year ] +
-                        mCarbonCalcs[ i ]->mTotalEmissionsBelow[ year ];
-                }
+                mCarbonCalcs[ i ]->addCurrEmissionsToTotal( *currEmissionsAbove[ i ], *currEmissionsBelow[ i ],
+                                                            -1.0, prevModelYear + 1, aEndYear );
             }
             else if( aCalcMode == ICarbonCalc::eReturnTotal ) {
                 mCarbonCalcs[ i ]->mStoredEmissions = mCarbonCalcs[ i ]->mTotalEmissionsAbove[ aEndYear ] +
@@ -44,6 +44,8 @@
 // iTp is used extensively in array declarations, so it's special
 #define iTp 740
 
+#include <string>
+#include <vector>
 #include "climate/include/MAGICC_array.h"
 
 //#define DEBUG_MAGICC++
@@ -392,6 +394,8 @@ float GETCARBONRESULTS(int, int);
 void SETPARAMETERVALUES(int, float);
 void overrideParameters( NEWPARAMS_block* NEWPARAMS, CAR_block* CAR, METH1_block* METH1, BCOC_block* BCOC );
 void SET_GAS_EMK( const std::string& GAS_EMK_DATA );
+void SET_GAS_EMK_VALUES( const std::string& SCENARIO_NAME, const std::vector<std::vector<float> >& GAS_EMK_VALUES );
+const std::vector<std::vector<float> >& GET_GAS_EMK_VALUES( std::string& SCENARIO_NAME );
 
 // Internal helper methods
 
@@ -191,6 +191,9 @@ private:
     //! output stream visitor
     std::auto_ptr<Hector::CSVOutputStreamVisitor> mHosv;
     
+    //! Latest year for which emissions have been sent to mHcore, or -1 if none.
+    int mLastEmissionsYear;
+    
     // private functions
     
     //! reset the Hector GCAM component and the Hector model for a new run
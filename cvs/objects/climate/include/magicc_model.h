@@ -198,7 +198,8 @@ private:
     void readFile();
     void overwriteMAGICCParameters( );
     void writeMAGICCEmissionsFile( );
-    void writeComma( int gasNumber, int& numberOfDataPoints, std::ostringstream& gasFile );
+    std::vector<float>& addGasRow( const int aYear, std::vector<std::vector<float> >& aGasRows );
+    std::string formatGasEMK( const std::vector<std::vector<float> >& aGasRows ) const;
         
     static int getNumAdditionalGasPoints();
 
@@ -1679,12 +1679,17 @@ void CLIMAT()
     //F 968       open(unit=lun,file='GAS.EMK',status='OLD')
     // Input gas data will be read out of a string rather than a gas.emk file to
     // facilitate in memory transfer of data from GCAM.
+    // When GCAM has set the data directly as values the text is not parsed
+    // at all.
     istringstream gasfile( GAS_EMK_DATA );
+    string gasValuesScenario;
+    const vector<vector<float> >& gasValues = GET_GAS_EMK_VALUES( gasValuesScenario );
+    const bool hasGasValues = !gasValues.empty();
     //F 969 !
     //F 970 !  READ HEADER AND NUMBER OR ROWS OF EMISIONS DATA FROM GAS.EMK
     //F 971 !
     //F 972       read(lun,4243)  NVAL
-    int NVAL = read_and_discard( &gasfile, DEBUG_IO );
+    int NVAL = hasGasValues ? static_cast<int>( gasValues.size() ) : read_and_discard( &gasfile, DEBUG_IO );
     
     if ( NVAL > 400 ) {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -1693,14 +1698,19 @@ void CLIMAT()
         NVAL = 400;
     }
     
-    //F 973       read(lun,'(a)') mnem
-    getline( gasfile, mnem );
-    //F 974       read(lun,*) !   skip description
-    skipline( &gasfile, DEBUG_IO );
-    //F 975       read(lun,*) !   skip column headings
-    skipline( &gasfile, DEBUG_IO );
-    //F 976       read(lun,*) !   skip units
-    skipline( &gasfile, DEBUG_IO );
+    if( hasGasValues ) {
+        mnem = gasValuesScenario;
+    }
+    else {
+        //F 973       read(lun,'(a)') mnem
+        getline( gasfile, mnem );
+        //F 974       read(lun,*) !   skip description
+        skipline( &gasfile, DEBUG_IO );
+        //F 975       read(lun,*) !   skip column headings
+        skipline( &gasfile, DEBUG_IO );
+        //F 976       read(lun,*) !   skip units
+        skipline( &gasfile, DEBUG_IO );
+    }
     //F 977 !
     //F 978 !  READ INPUT EMISSIONS DATA FROM GAS.EMK
     //F 979 !  SO2 EMISSIONS (BY REGION) MUST BE INPUT AS CHANGES FROM 1990.
@@ -1743,7 +1753,32 @@ void CLIMAT()
         //F 991 
         //F 992 ! For objects, read in our csv format.
         //F 993 	 IF ( iReadNative .EQ. 0 )THEN
-        if( iReadNative == 0 ) {
+        if( iReadNative == 0 && hasGasValues ) {
+            // Same column order as the csv format below.
+            const vector<float>& row = gasValues[ i - 1 ];
+            IY1[ i ] = row[ 0 ];
+            FOS[ i ] = row[ 1 ];
+            DEF[ i ] = row[ 2 ];
+            DCH4[ i ] = row[ 3 ];
+            DN2O[ i ] = row[ 4 ];
+            DSO21[ i ] = row[ 5 ];
+            DSO22[ i ] = row[ 6 ];
+            DSO23[ i ] = row[ 7 ];
+            DCF4[ i ] = row[ 8 ];
+            DC2F6[ i ] = row[ 9 ];
+            D125[ i ] = row[ 10 ];
+            D134A[ i ] = row[ 11 ];
+            D143A[ i ] = row[ 12 ];
+            D227[ i ] = row[ 13 ];
+            D245[ i ] = row[ 14 ];
+            DSF6[ i ] = row[ 15 ];
+            DNOX[ i ] = row[ 16 ];
+            DVOC[ i ] = row[ 17 ];
+            DCO[ i ] = row[ 18 ];
+            DBC[ i ] = row[ 19 ];
+            DOC[ i ] = row[ 20 ];
+        }
+        else if( iReadNative == 0 ) {
             //F 994         read(lun,*) IY1(I),FOS(I),DEF(I),DCH4(I),DN2O(I), &
             IY1[ i ] = read_csv_value( &gasfile, DEBUG_IO );
             FOS[ i ] = read_csv_value( &gasfile, DEBUG_IO );
@@ -4810,6 +4810,8 @@ HALOF_block* G_HALOF = new HALOF_block;
 NEWPARAMS_block* G_NEWPARAMS = new NEWPARAMS_block;
 BCOC_block* G_BCOC = new BCOC_block;
 string G_GAS_EMK_DATA;
+string G_GAS_EMK_SCENARIO;
+vector<vector<float> > G_GAS_EMK_VALUES;
 
 
 
@@ -5527,5 +5529,21 @@ float GETCARBONRESULTS( int iResultNumber, int inYear )
 // A method to set the gas.emk data from GCAM.
 void SET_GAS_EMK( const string& GAS_EMK_DATA ) {
     G_GAS_EMK_DATA = GAS_EMK_DATA;
+    G_GAS_EMK_VALUES.clear();
+}
+
+// A method to set the gas.emk data from GCAM directly as rows of values, one
+// row per year with the year followed by each gas in the gas.emk column order.
+// This avoids formatting the data as text only to parse it again.
+void SET_GAS_EMK_VALUES( const string& SCENARIO_NAME, const vector<vector<float> >& GAS_EMK_VALUES ) {
+    G_GAS_EMK_SCENARIO = SCENARIO_NAME;
+    G_GAS_EMK_VALUES = GAS_EMK_VALUES;
+    G_GAS_EMK_DATA.clear();
+}
+
+// Get the gas.emk rows set from GCAM, empty if the data was set as text.
+const vector<vector<float> >& GET_GAS_EMK_VALUES( string& SCENARIO_NAME ) {
+    SCENARIO_NAME = G_GAS_EMK_SCENARIO;
+    return G_GAS_EMK_VALUES;
 }
 
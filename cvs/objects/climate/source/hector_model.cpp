@@ -83,6 +83,30 @@ namespace {
 
     // don't ask
     bool hector_log_is_init = false;
+
+    /*!
+     * \brief Roll a Hector core back to a previous date.
+     * \details Versions of Hector which keep the history of the state of each
+     *          component provide Core::reset to restore it as of a given date.
+     *          This overload is only selected when that method exists.
+     * \param aCore The Hector core to roll back.
+     * \param aDate The date to restore the state of.
+     * \return True since the core was rolled back.
+     */
+    template<typename CoreType>
+    auto rollBackCore( CoreType* aCore, const double aDate, int ) -> decltype( aCore->reset( aDate ), bool() ) {
+        aCore->reset( aDate );
+        return true;
+    }
+
+    /*!
+     * \brief Fallback for versions of Hector which can not be rolled back.
+     * \return False to indicate the core must be rebuilt.
+     */
+    template<typename CoreType>
+    bool rollBackCore( CoreType* aCore, const double aDate, long ) {
+        return false;
+    }
 } 
 
 HectorModel::HectorModel()
@@ -98,6 +122,7 @@ HectorModel::HectorModel()
     mEmissionsSwitchYear = def_switch_year;
     // Hector config location.  
     mHectorIniFile = def_ini_file; 
+    mLastEmissionsYear = -1;
 }
 
 
@@ -330,17 +355,36 @@ void HectorModel::completeInit( const string& aScenarioName ) {
  *
  * \details Reset the hector model back to a previous time period so
  *          that we can run a new scenario or rerun some periods that
- *          we've already done.  Currently this entails shutting down
- *          all of the hector components, freeing them, and
- *          re-initializing.  Hopefully we will at some point fix
- *          hector so that we can just roll it back to a previous
- *          time.
+ *          we've already done.  When the Hector core keeps the history of
+ *          its state and no emissions after aPeriod have been sent to it
+ *          the core is simply rolled back to the last year of the period
+ *          before aPeriod, which is not affected by the emissions in
+ *          aPeriod, so that only the years after it need to be run again.
+ *          The emissions already sent to the core are then the same as
+ *          those that would be replayed.  Otherwise this entails shutting
+ *          down all of the hector components, freeing them,
+ *          re-initializing and replaying the emissions up to aPeriod so
+ *          that emissions for later periods are discarded.
  */
 void HectorModel::reset( const int aPeriod ) {
     ILogger& climatelog = ILogger::getLogger( "climate-log" );
     climatelog.setLevel( ILogger::DEBUG );
 
     climatelog << "Hector reset to period= " << aPeriod << endl;
+
+    const Modeltime* modeltime = scenario->getModeltime();
+    // Period 0 emissions are never replayed so the core can only be rolled
+    // back to it if no emissions have been sent at all.
+    const int rollBackYear = modeltime->getper_to_yr( max( aPeriod - 1, 0 ) );
+    const int lastKeptYear = aPeriod > 0 ? modeltime->getper_to_yr( aPeriod ) : -1;
+    if( mHcore.get() && mOfile.get() && rollBackYear <= mLastYear && mLastEmissionsYear <= lastKeptYear &&
+        rollBackCore( mHcore.get(), static_cast<double>( rollBackYear ), 0 ) )
+    {
+        climatelog << "Rolled back Hector core to year= " << rollBackYear << endl;
+        (*mOfile) << "\n\n################ Hector Core Reset to " << rollBackYear << " ################\n\n";
+        mLastYear = rollBackYear;
+        return;
+    }
     
     if (mHcore.get() ) {
         // shutdown all Hector components and delete.
@@ -366,8 +410,7 @@ void HectorModel::reset( const int aPeriod ) {
     coreParser.parse( mHectorIniFile );
     mHcore->addVisitor( mHosv.get() ); 
     mHcore->prepareToRun();
-
-    const Modeltime* modeltime = scenario->getModeltime();
+    mLastEmissionsYear = -1;
 
     // loop over all gasses
     map<std::string, std::vector<double> >::iterator it;
@@ -456,6 +499,7 @@ bool HectorModel::setEmissionsByYear( const string& aGasName,
                          Hector::message_data( static_cast<double>( aYear ),
                          Hector::unitval( emiss,
                          static_cast<Hector::unit_types>( mHectorUnits[ aGasName ] ) ) ) ); 
+    mLastEmissionsYear = max( mLastEmissionsYear, aYear );
     return true;
 }
 
@@ -497,41 +497,34 @@ double MagiccModel::getEmissions( const string& aGasName,
     return static_cast<double>( ( aYear - x1 ) * ( y2 - y1 ) ) / static_cast<double>( ( x2 - x1 ) ) + y1;
 }
 
-/*! \brief Write out the MAGICC emissions file.
- * \details This function writes emissions to the MAGICC input file.
+/*! \brief Pass the emissions to MAGICC.
+ * \details This function assembles the emissions MAGICC reads as its gas.emk
+ *          input and hands them directly to MAGICC as rows of values, one
+ *          row per year with the year followed by each input gas.
  *          The first part of this function writes out historical data from
  *          the default emissions file. This data can be for any years, but
  *          must include the model critical year (2000). 
  *          GCAM emissions are used for years past the last historical year
  *          as specified by the user. 
  *          Emissions are interpolated in-between years without data.
+ *          The equivalent gas.emk text is only formatted if the user has
+ *          requested the file be written.
  */
 void MagiccModel::writeMAGICCEmissionsFile(){
-    const int OUT_PRECISION = 4; // Number of decimals
-    
-    // Open a stringstream until are ready to print to file
-    ostringstream gasFileData;
-    
-    // Setup the output format.
-    gasFileData.setf( ios::right, ios::adjustfield );
-    gasFileData.setf( ios::fixed, ios::floatfield );
-    gasFileData.setf( ios::showpoint );
+    // Rows of year followed by the emissions for each gas.
+    vector<vector<float> > gasRows;
 
     int lastHistoricalData = 0; // Last historical data point written out
-    int numberOfDataPoints = 0; // Number of data points written to magicc input file
 
     // First write out data for historical years
     for( unsigned int index = 0; index < mNumberHistoricalDataPoints; ++index ){
         int year = static_cast<int>( floor( mDefaultEmissionsByGas[ 0 ][ index ] ) );
         if ( ( year <= mLastHistoricalYear ) ) {
-            gasFileData << setw( 4 ) <<  year << ",";
+            vector<float>& row = addGasRow( year, gasRows );
             lastHistoricalData = index;
             for( unsigned int gasNumber = 0; gasNumber < getNumInputGases(); ++gasNumber ){
                 // Write out exogenous emissions for each gas.
-                gasFileData << setw( 6 + OUT_PRECISION ) << setprecision( OUT_PRECISION ) << mDefaultEmissionsByGas[ gasNumber +1 ][ index ];
-                
-                // Need to deal with 1) interpolation between history and model, 
-                writeComma( gasNumber, numberOfDataPoints, gasFileData );
+                row[ gasNumber + 1 ] = mDefaultEmissionsByGas[ gasNumber +1 ][ index ];
             }
         }
         else { // If are past last historical year, exit loop, finished writting default emissions
@@ -556,20 +549,16 @@ void MagiccModel::writeMAGICCEmissionsFile(){
         // If are past historical years, write out model emissions for every year past final cal year, a model year, and GAS_EMK_CRIT_YEAR 
         if ( year > mLastHistoricalYear ) { 
             if ( modeltime->isModelYear( year ) || year == GAS_EMK_CRIT_YEAR || year > finalCalYear ) {
-                std::vector<int>::iterator yearIterator; // Need this several times
+                vector<float>& row = addGasRow( year, gasRows );
                
                 // Write out model emissions for all the gases if past historical emissions year.
                 for( unsigned int gasNumber = 0; gasNumber < getNumInputGases(); ++gasNumber ){
-                     if ( gasNumber == 0 ) {
-                        gasFileData << setw( 4 ) << year << ",";
-                    }
                     // We are always passing GCAM LUC carbon emissions to MAGICC annually.
                     // Therefore, LUC Emissions are not interpolated between historical and GCAM values.
                     // Historical LUC emissions vary from year-to year in any event, so some jumps between historical
                     // and model data are acceptable
                     if ( sInputGasNames[ gasNumber ] == "CO2NetLandUse" ) { 
-                        gasFileData << setw(  6 + OUT_PRECISION ) << setprecision( OUT_PRECISION )
-                                    << mLUCEmissionsByYear[ year - modeltime->getStartYear() - 1 ];
+                        row[ gasNumber + 1 ] = mLUCEmissionsByYear[ year - modeltime->getStartYear() - 1 ];
                     }
                     // For all emissions other than LUC carbon
                     else {
@@ -587,16 +576,13 @@ void MagiccModel::writeMAGICCEmissionsFile(){
                                 previousValue = mDefaultEmissionsByGas[ gasNumber + 1 ] [ lastHistoricalData ];
                             }
                             
-                            gasFileData << setw(  6 + OUT_PRECISION ) << setprecision( OUT_PRECISION )
-                             << util::linearInterpolateY( year, prevYear, nextYear, previousValue, nextValue );
+                            row[ gasNumber + 1 ] = util::linearInterpolateY( year, prevYear, nextYear, previousValue, nextValue );
                         }
                         else {
                             // Write out model emission for this gas.
-                            gasFileData << setw(  6 + OUT_PRECISION ) << setprecision( OUT_PRECISION )
-                                        << mModelEmissionsByGas[ gasNumber ][ period ];
+                            row[ gasNumber + 1 ] = mModelEmissionsByGas[ gasNumber ][ period ];
                         }
                     }
-                    writeComma( gasNumber, numberOfDataPoints, gasFileData );
                 } // end gasnumber loop 
             } // end loop - write-out model emissions.
         } 
@@ -612,29 +598,55 @@ void MagiccModel::writeMAGICCEmissionsFile(){
         int period = modeltime->getmaxper();
         for ( unsigned int extra = 0; extra < getNumAdditionalGasPoints(); extra++ ) {
             year = year + 10;
-            gasFileData << setw( 4 ) << year << ",";
+            vector<float>& row = addGasRow( year, gasRows );
             // Write out all the gases.
             for( unsigned int gasNumber = 0; gasNumber < getNumInputGases(); ++gasNumber ){
                 if ( sInputGasNames[ gasNumber ] == "CO2NetLandUse" ) {
                     int index = modeltime->getEndYear() - modeltime->getStartYear() + extra - 1;
-                    gasFileData << setw(  6 + OUT_PRECISION ) << setprecision( OUT_PRECISION )
-                    << mLUCEmissionsByYear[ index ];
+                    row[ gasNumber + 1 ] = mLUCEmissionsByYear[ index ];
                 }
                 else {
-                    gasFileData << setw(  6 + OUT_PRECISION ) << setprecision( OUT_PRECISION ) 
-                                << mModelEmissionsByGas[ gasNumber ][ period ]; //sjsTEMP - this should be +1, but that's strange.
+                    row[ gasNumber + 1 ] = mModelEmissionsByGas[ gasNumber ][ period ]; //sjsTEMP - this should be +1, but that's strange.
                 }
-                writeComma( gasNumber, numberOfDataPoints, gasFileData );
             }
         }
     }
     
-    // Open the gas stream to write emissions into so that MAGICC can get them by
-    // reading this stream.
+    // Set the gas data into MAGICC.
+    SET_GAS_EMK_VALUES( " Scenario " + mScenarioName, gasRows );
+    
+    // Check if the users still wants the gas data saved as a file which may be
+    // useful for debugging or to use as input for a stand alone MAGICC run.
+    // Skip formatting the text entirely when it would be discarded.
+    if( Configuration::getInstance()->shouldWriteFile( "climatFileName" ) ) {
+        AutoOutputFile gasFile( "climatFileName", "gas.emk" );
+        string gasEMKData = formatGasEMK( gasRows );
+        gasFile << gasEMKData;
+    }
+}
+
+/*! \brief Add a row for the given year to the MAGICC emissions.
+ * \param aYear The year of the new row.
+ * \param aGasRows The emissions rows to add to.
+ * \return The new row which has room for each input gas.
+ */
+vector<float>& MagiccModel::addGasRow( const int aYear, vector<vector<float> >& aGasRows ){
+    aGasRows.push_back( vector<float>( getNumInputGases() + 1, 0.0f ) );
+    aGasRows.back()[ 0 ] = static_cast<float>( aYear );
+    return aGasRows.back();
+}
+
+/*! \brief Format the MAGICC emissions in the gas.emk file format.
+ * \param aGasRows The emissions rows to format.
+ * \return The gas.emk text.
+ */
+string MagiccModel::formatGasEMK( const vector<vector<float> >& aGasRows ) const {
+    const int OUT_PRECISION = 4; // Number of decimals
+    
     ostringstream gasStream;
     
     // Write out header information
-    gasStream << numberOfDataPoints << endl;
+    gasStream << aGasRows.size() << endl;
 	
     // line 2: Name of the scenario
     gasStream << " Scenario " << mScenarioName << endl;
@@ -653,31 +665,23 @@ void MagiccModel::writeMAGICCEmissionsFile(){
     }
     gasStream << endl;
     
-    // Transfer bulk of data to output stream.
-    gasStream << gasFileData.str(); 
-    
-    // Set the gas data into MAGICC.
-    SET_GAS_EMK( gasStream.str() );
+    // Setup the output format.
+    gasStream.setf( ios::right, ios::adjustfield );
+    gasStream.setf( ios::fixed, ios::floatfield );
+    gasStream.setf( ios::showpoint );
     
-    // Check if the users still wants the gas data saved as a file which may be
-    // useful for debugging or to use as input for a stand alone MAGICC run.
-    AutoOutputFile gasFile( "climatFileName", "gas.emk" );
-    string gasEMKData = gasStream.str();
-    gasFile << gasEMKData;
-}
-
-/*! \brief Write comma.
- * \details Helper function that writes comma separator for emissions and adds one to line counter.
- */
-void MagiccModel::writeComma( int gasNumber, int& numberOfDataPoints, ostringstream& gasFile ){
-    // Write a comma as long as this is not the last gas.
-    if( gasNumber != getNumInputGases() - 1 ){
-        gasFile << ",";
-    }
-    else {
-        gasFile << endl;
-        numberOfDataPoints++;
+    for( vector<vector<float> >::const_iterator row = aGasRows.begin(); row != aGasRows.end(); ++row ) {
+        gasStream << setw( 4 ) << static_cast<int>( ( *row )[ 0 ] ) << ",";
+        for( unsigned int gasNumber = 0; gasNumber < getNumInputGases(); ++gasNumber ){
+            gasStream << setw( 6 + OUT_PRECISION ) << setprecision( OUT_PRECISION ) << ( *row )[ gasNumber + 1 ];
+            // Write a comma as long as this is not the last gas.
+            if( gasNumber != getNumInputGases() - 1 ){
+                gasStream << ",";
+            }
+        }
+        gasStream << endl;
     }
+    return gasStream.str();
 }
     
 /*! \brief Run the MAGICC emissions model.
@@ -46,10 +46,12 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <memory>
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/iscenario_runner.h"
 class Timer;
+class BatchCSVOutputter;
 
 /*! 
  * \ingroup Objects
@@ -74,7 +76,9 @@ class Timer;
  *          
  *          The batch runner is turned on using the boolean configuration value
  *          "BatchMode". The name of the configuration file is determined by the
- *          file configuration value "BatchFileName".
+ *          file configuration value "BatchFileName". Setting the integer
+ *          configuration value "batch-workers" above one runs that many
+ *          scenarios at once in forked copies of the process.
  *
  *          <b>XML specification for BatchRunner</b>
  *          - XML name: \c BatchRunner
@@ -184,6 +188,14 @@ protected:
                             const int aSinglePeriod,
                             Timer& aTimer );
 
+    bool canRunForked() const;
+
+    bool runScenariosForked( const std::vector<Component>& aRuns,
+                             const unsigned int aNumWorkers,
+                             const int aSinglePeriod,
+                             Timer& aTimer,
+                             BatchCSVOutputter& aCSVOutputter );
+
     bool XMLParseComponentSet( const xercesc::DOMNode* aNode );
 
     bool XMLParseRunnerSet( const xercesc::DOMNode* aNode );
@@ -48,6 +48,7 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
 
 class Marketplace;
 class IActivity;
@@ -96,8 +97,12 @@ public:
 
     const std::vector<IActivity*> getOrdering( const int aMarketNumber = -1 ) const;
 
+    const std::vector<int>& getCoupledMarkets( const int aMarketNumber );
+
 #if GCAM_PARALLEL_ENABLED
     GcamFlowGraph* getFlowGraph( const int aMarketNumber = -1 );
+    
+    void createMarketFlowGraphs( const std::vector<int>& aMarketNumbers );
 #endif
 
     void resolveActivityToDependency( const std::string& aRegionName, 
@@ -296,6 +301,11 @@ public:
         //! the first time it is needed.
         std::vector<IActivity*> mCalcList;
 
+        //! The sorted market numbers whose supply or demand may change should
+        //! this market change it's price.  Note that this is essentially a cache
+        //! and only computed the first time it is needed.
+        std::vector<int> mCoupledMarkets;
+
 #if GCAM_PARALLEL_ENABLED
         //! A flow graph of vertices to re-calculate in parallel should this market
         //! change it's price.  Note that this is essentially a cache and only computed
@@ -332,6 +342,15 @@ public:
     //! A UID counter to able to compare CalcVertex uniquely between runs
     int mCalcVertexUIDCount;
 
+    //! A map from an activity to the market numbers which will recalculate it
+    //! should they change price.  Note this is only filled in the first time
+    //! getCoupledMarkets is called.
+    std::map<IActivity*, std::vector<int> > mActivityToMarkets;
+
+    //! The trial price market number to trial demand market number and vice versa
+    //! for each item which was converted to be solved via trial markets.
+    std::map<int, int> mTrialMarketPairs;
+
 #if GCAM_PARALLEL_ENABLED
     //! The global flow graph to calculate the full model in parallel
     GcamFlowGraph* mTBBGraphGlobal;
@@ -102,6 +102,7 @@ public:
 
     const std::string& getName() const;
     bool run( const int aSinglePeriod, const bool aPrintDebugging, const std::string& aFilenameEnding = "" );
+    bool runFromPeriod( const int aFirstPeriod, const bool aPrintDebugging, const std::string& aFilenameEnding = "" );
     void setTax( const GHGPolicy* aTax );
     std::map<std::string, const Curve*> getEmissionsQuantityCurves( const std::string& ghgName ) const;
     std::map<std::string, const Curve*> getEmissionsPriceCurves( const std::string& ghgName ) const;
@@ -159,6 +160,10 @@ protected:
 
     bool solve( const int period );
 
+    bool runPeriods( const int aFirstPeriod,
+        const int aLastPeriod,
+        const bool aPrintDebugging );
+
     bool calculatePeriod( const int aPeriod,
         std::ostream& aXMLDebugFile,
         Tabs* aTabs,
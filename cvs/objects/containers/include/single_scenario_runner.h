@@ -68,6 +68,10 @@ class XMLDBOutputter;
  *          -# Scenario components passed into the function, in the order they
  *             are passed in.
  *
+ *          parseCommonInputs may be called ahead of setupScenarios to parse the
+ *          first two of these once so that several runs forked from this
+ *          process can share them.
+ *
  *          setupScenarios must be called before runScenarios. runScenarios may
  *          be called multiple times, as in the case when total policy costs are
  *          calculated. Care should be taken to ensure that operations that
@@ -112,9 +116,12 @@ public:
 
     XMLDBOutputter* getXMLDBOutputter() const;
 
+    bool parseCommonInputs( Timer& aTimer );
+
+    static const std::string& getXMLNameStatic();
+
 protected:    
     SingleScenarioRunner();
-    static const std::string& getXMLNameStatic();
     //! The scenario which will be run.
     std::auto_ptr<Scenario> mScenario;
 
@@ -122,5 +129,11 @@ protected:
     //! it around in case we want to do additional processing once GCAM
     //! is done running.
     mutable XMLDBOutputter* mXMLDBOutputter;
+
+    //! Whether mScenario holds only the parsed common inputs which the next
+    //! call to setupScenarios should continue from.
+    bool mIsCommonInputParsed;
+
+    bool parseComponents( const std::list<std::string>& aScenComponents );
 };
 #endif // _SINGLE_SCENARIO_RUNNER_H_
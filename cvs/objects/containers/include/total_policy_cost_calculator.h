@@ -48,6 +48,7 @@
 #include <map>
 #include <memory>
 #include <vector>
+#include <string>
 
 class SingleScenarioRunner;
 class Curve;
@@ -83,6 +84,9 @@ private:
     //! The name of the GHG for which to calculate the marginal abatement curve.
     std::string mGHGName;
 
+    //! The number of trials to run at once in forked workers.
+    int mNumWorkers;
+
     //! The scenario runner which controls running the initial scenario, and all
     //! fixed taxed scenarios after. This is a weak reference.
     SingleScenarioRunner* mSingleScenario;
@@ -108,6 +112,12 @@ private:
     RegionCurves mRegionalCostCurves;
 
     bool runTrials();
+    bool runTrialsForked();
+    void setTrialTaxes( const double aFraction );
+    static const Curve* createYearCurve( const std::vector<double>& aValues,
+                                         const size_t aFirstIndex,
+                                         const std::string& aTitle,
+                                         const std::string& aYLabel );
     void createCostCurvesByPeriod();
     void createRegionalCostCurves();
     const std::string createXMLOutputString() const;
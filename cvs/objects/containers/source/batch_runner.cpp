@@ -43,16 +43,21 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <vector>
+#include <sstream>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "containers/include/batch_runner.h"
 #include "containers/include/scenario_runner_factory.h"
+#include "containers/include/single_scenario_runner.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/configuration.h"
 #include "util/logger/include/ilogger.h"
 #include "containers/include/scenario.h"
 #include "reporting/include/batch_csv_outputter.h"
+#include "reporting/include/xml_db_outputter.h"
+#include "util/base/include/forked_workers.h"
 
 using namespace std;
 using namespace xercesc;
@@ -135,8 +140,7 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
     // All generated scenarios are run with each scenario runner in the order in
     // which the scenario runners were read.
     bool shouldExit = false;
-    bool success = true;
-    BatchCSVOutputter csvOutputter;
+    vector<Component> runs;
     while( !shouldExit ){
         // The data structure containing the current run.
         Component fileSetsToRun;
@@ -146,17 +150,7 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             fileSetsToRun.mFileSets.push_back( *( currSet->mFileSetIterator ) );
             fileSetsToRun.mName += currSet->mFileSetIterator->mName;
         }
-
-        // Run it using each possible type of IScenarioRunner.
-        for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
-            bool scenarioSuccess = runSingleScenario( *runner, fileSetsToRun, aSinglePeriod, aTimer );
-            success &= scenarioSuccess;
-            (*runner)->getInternalScenario()->accept( &csvOutputter, -1 );
-            csvOutputter.writeDidScenarioSolve( scenarioSuccess );
-            // Clean up the current scenario runner before we move on to the next
-            // so that we do not accumulate a large amount of idle memory.
-            (*runner)->cleanup();
-        }
+        runs.push_back( fileSetsToRun );
 
         // Loop forward to find a position to increment.
         for( ComponentSet::iterator outPos = mComponentSet.begin(); outPos != mComponentSet.end(); ++outPos ){
@@ -175,6 +169,152 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             }
         }
     }
+
+    // The scenarios are independent of each other so run them at once if
+    // requested and possible.
+    BatchCSVOutputter csvOutputter;
+    const int numWorkers = Configuration::getInstance()->getInt( "batch-workers", 1 );
+    if( numWorkers > 1 && canRunForked() ){
+        return runScenariosForked( runs, numWorkers, aSinglePeriod, aTimer, csvOutputter );
+    }
+
+    bool success = true;
+    for( vector<Component>::const_iterator currRun = runs.begin(); currRun != runs.end(); ++currRun ){
+        // Run it using each possible type of IScenarioRunner.
+        for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
+            bool scenarioSuccess = runSingleScenario( *runner, *currRun, aSinglePeriod, aTimer );
+            success &= scenarioSuccess;
+            (*runner)->getInternalScenario()->accept( &csvOutputter, -1 );
+            csvOutputter.writeDidScenarioSolve( scenarioSuccess );
+            // Clean up the current scenario runner before we move on to the next
+            // so that we do not accumulate a large amount of idle memory.
+            (*runner)->cleanup();
+        }
+    }
+    return success;
+}
+
+/*!
+ * \brief Whether scenarios can be run concurrently in forked workers.
+ * \details Forking must be supported by this build.  The XML database may not
+ *          be written through Java from a worker as the JVM does not survive a
+ *          fork and the database only allows a single writer, however the
+ *          columnar backend writes a separate file for each scenario and so is
+ *          safe to use.  Restart and debug files, if written, must have the
+ *          scenario name appended so that workers do not overwrite each
+ *          other's.  Each worker writes its logs to its own files.
+ * \return True if the scenarios can be run in forked workers.
+ */
+bool BatchRunner::canRunForked() const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::WARNING );
+    if( !ForkedWorkers::isEnabled() ){
+        mainLog << "Forked workers are not supported by this build, running batch scenarios one at a time." << endl;
+        return false;
+    }
+    if( Configuration::getInstance()->shouldWriteFile( "xmldb-location" ) &&
+        !XMLDBOutputter::isColumnarBackend() )
+    {
+        mainLog << "The XML database can only be written by forked workers with the columnar backend,"
+                << " running batch scenarios one at a time." << endl;
+        return false;
+    }
+    // Workers write their restart and debug files concurrently so each must be
+    // named for its scenario.
+    const Configuration* conf = Configuration::getInstance();
+    if( ( conf->shouldWriteFile( "restart", false, false ) && !conf->shouldAppendScnToFile( "restart" ) ) ||
+        ( conf->shouldWriteFile( "xmlDebugFileName" ) && !conf->shouldAppendScnToFile( "xmlDebugFileName" ) ) )
+    {
+        mainLog << "Restart and debug files must be written with append-scenario-name by forked workers,"
+                << " running batch scenarios one at a time." << endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Run all scenarios concurrently in forked workers.
+ * \details Scenarios are run with one scenario runner at a time.  When the
+ *          runner is a SingleScenarioRunner the base input file and configured
+ *          scenario components are parsed once in this process and each worker
+ *          starts from a copy of them, only parsing the file sets specific to
+ *          its scenario.  Each worker reports whether its scenario solved along
+ *          with its batch CSV output which is written in the same order as a
+ *          serial batch run.  A scenario whose worker failed to report is run
+ *          again in this process.
+ * \param aRuns The file sets for each scenario to run.
+ * \param aNumWorkers The maximum number of workers to run at once.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \param aCSVOutputter The outputter to write the batch CSV output to.
+ * \return Whether all model runs solved successfully.
+ */
+bool BatchRunner::runScenariosForked( const vector<Component>& aRuns,
+                                      const unsigned int aNumWorkers,
+                                      const int aSinglePeriod,
+                                      Timer& aTimer,
+                                      BatchCSVOutputter& aCSVOutputter )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const size_t numRunners = mScenarioRunners.size();
+    vector<string> results( aRuns.size() * numRunners );
+    size_t runnerIndex = 0;
+    for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner, ++runnerIndex ){
+        IScenarioRunner* currRunner = *runner;
+
+        // Share parsing the inputs which are common to all scenarios.
+        if( currRunner->getName() == SingleScenarioRunner::getXMLNameStatic() ){
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Parsing common inputs for batch scenarios." << endl;
+            if( !static_cast<SingleScenarioRunner*>( currRunner )->parseCommonInputs( aTimer ) ){
+                mainLog.setLevel( ILogger::WARNING );
+                mainLog << "Parsing common inputs failed, each scenario will parse them." << endl;
+            }
+        }
+
+        vector<ForkedWorkers::TextTask> tasks;
+        for( vector<Component>::const_iterator currRun = aRuns.begin(); currRun != aRuns.end(); ++currRun ){
+            tasks.push_back( [this, currRunner, currRun, aSinglePeriod, &aTimer]() {
+                // The first character of the result flags whether the scenario
+                // solved followed by the captured batch CSV output.
+                const bool scenarioSuccess = runSingleScenario( currRunner, *currRun, aSinglePeriod, aTimer );
+                ostringstream csvOutput;
+                BatchCSVOutputter workerOutputter( csvOutput );
+                currRunner->getInternalScenario()->accept( &workerOutputter, -1 );
+                workerOutputter.writeDidScenarioSolve( scenarioSuccess );
+                currRunner->cleanup();
+                return ( scenarioSuccess ? string( "1" ) : string( "0" ) ) + csvOutput.str();
+            } );
+        }
+
+        // The names of unsolved scenarios are recorded here rather than by the
+        // workers.
+        const size_t numUnsolved = mUnsolvedNames.size();
+        vector<string> runnerResults = ForkedWorkers::runText( tasks, aNumWorkers );
+        for( size_t i = 0; i < tasks.size(); ++i ){
+            if( runnerResults[ i ].empty() ){
+                mainLog.setLevel( ILogger::WARNING );
+                mainLog << "Scenario " << aRuns[ i ].mName
+                        << " did not complete in a worker, running it again." << endl;
+                runnerResults[ i ] = tasks[ i ]();
+            }
+            results[ i * numRunners + runnerIndex ].swap( runnerResults[ i ] );
+        }
+        mUnsolvedNames.resize( numUnsolved );
+        currRunner->cleanup();
+    }
+
+    // Write the output in the order of a serial run.
+    bool success = true;
+    for( size_t i = 0; i < results.size(); ++i ){
+        const bool scenarioSuccess = results[ i ][ 0 ] == '1';
+        success &= scenarioSuccess;
+        if( !scenarioSuccess ){
+            mUnsolvedNames.push_back( aRuns[ i / numRunners ].mName );
+        }
+        aCSVOutputter.writeCapturedOutput( results[ i ].substr( 1 ) );
+    }
     return success;
 }
 
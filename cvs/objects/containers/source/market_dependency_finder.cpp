@@ -51,7 +51,9 @@
 #include "containers/include/iactivity.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
 #include "parallel/include/gcam_parallel.hpp"
+#include "util/base/include/timer.h"
 #endif
 
 using namespace std;
@@ -257,11 +259,82 @@ const vector<IActivity*> MarketDependencyFinder::getOrdering( const int aMarketN
     }
 }
 
+/*!
+ * \brief Get the markets whose supply or demand may change should the given market
+ *        change it's price.
+ * \details Two markets are considered coupled if any activity would need to be
+ *          recalculated when either of them changes price.  Given that every
+ *          activity which adds supply or demand to a market also depends on the
+ *          price of that market this gives a conservative estimate of the rows in
+ *          a Jacobian in which the column for aMarketNumber may be non-zero.  The
+ *          trial price and trial demand markets created to break a cycle are always
+ *          considered coupled since demands for the price market are redirected into
+ *          the demand market.  The result always includes aMarketNumber itself.
+ * \param aMarketNumber The market number to get the coupled markets for.
+ * \return A sorted list of coupled market numbers.  Note that this list is cached
+ *         and the caller is not responsible for the returned memory.
+ */
+const vector<int>& MarketDependencyFinder::getCoupledMarkets( const int aMarketNumber ) {
+    auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( aMarketNumber ) );
+    CMarketToDepIterator mrktIter = mMarketsToDep.find( marketToDep.get() );
+    if( mrktIter == mMarketsToDep.end() ) {
+        // Somehow this market was not linked to any entry points into the graph.
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not find market: " << mMarketplace->mMarkets[ aMarketNumber ]->getName()
+                << " to get coupled markets for." << endl;
+        exit( 1 );
+    }
+
+    // First check the MarketToDependencyItem and see if we have this cached.
+    if( !(*mrktIter)->mCoupledMarkets.empty() ) {
+        return (*mrktIter)->mCoupledMarkets;
+    }
+
+    // The first time through we must build a reverse lookup from each activity to
+    // the markets which would cause it to be recalculated.
+    if( mActivityToMarkets.empty() ) {
+        for( CMarketToDepIterator it = mMarketsToDep.begin(); it != mMarketsToDep.end(); ++it ) {
+            if( (*it)->mImpliedVertices.empty() ) {
+                continue;
+            }
+            const vector<IActivity*> calcList = getOrdering( (*it)->mMarket );
+            for( vector<IActivity*>::const_iterator calcIter = calcList.begin(); calcIter != calcList.end(); ++calcIter ) {
+                mActivityToMarkets[ *calcIter ].push_back( (*it)->mMarket );
+            }
+        }
+    }
+
+    set<int> coupled;
+    coupled.insert( aMarketNumber );
+    const vector<IActivity*> calcList = getOrdering( aMarketNumber );
+    for( vector<IActivity*>::const_iterator calcIter = calcList.begin(); calcIter != calcList.end(); ++calcIter ) {
+        const vector<int>& markets = mActivityToMarkets[ *calcIter ];
+        coupled.insert( markets.begin(), markets.end() );
+    }
+
+    // Include the partner of any trial market pairs.
+    vector<int> coupledList( coupled.begin(), coupled.end() );
+    for( vector<int>::const_iterator it = coupledList.begin(); it != coupledList.end(); ++it ) {
+        map<int, int>::const_iterator pairIter = mTrialMarketPairs.find( *it );
+        if( pairIter != mTrialMarketPairs.end() ) {
+            coupled.insert( (*pairIter).second );
+        }
+    }
+
+    // Go ahead and cache this list so we do not need to calculate it again.
+    (*mrktIter)->mCoupledMarkets.assign( coupled.begin(), coupled.end() );
+    return (*mrktIter)->mCoupledMarkets;
+}
+
 #if GCAM_PARALLEL_ENABLED
 /*!
  * \brief Get flow graph which can be used to calculate the model in parallel.
  * \details If called with a market number of -1 (the default value) then the global
  *          graph which will calculate all objects in the model is returned.
+ *          The global graph records the cost of each activity for the first
+ *          parallel-profile-calls model calculations, after which calling this
+ *          method again will rebuild it with grains weighted by those costs.
  *          When a valid market number is given the flow graph of activities which
  *          would be affected by that market changing it's price would be generated
  *          and returned.
@@ -273,16 +346,21 @@ const vector<IActivity*> MarketDependencyFinder::getOrdering( const int aMarketN
  */
 GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
     if( aMarketNumber == -1 ) {
-        if( !mTBBGraphGlobal ) {
-            // reads parameters from the global configuration
-            GcamParallel config;
+        // reads parameters from the global configuration
+        GcamParallel config;
+        // Once the activities of the global graph have been profiled rebuild it with
+        // the grains weighted by the measured costs.
+        const bool shouldRebuild = mTBBGraphGlobal && config.getNumProfileCalls() > 0
+            && !mTBBGraphGlobal->mIsCostWeighted && mTBBGraphGlobal->mProfileCallsRemaining == 0;
+        if( !mTBBGraphGlobal || shouldRebuild ) {
             GcamParallel::FlowGraph gcamFlowGraph;
             GcamParallel::FlowGraph grainGraph;
 
             // convert dependency table to flow graph 
             config.makeGCAMFlowGraph( *this, gcamFlowGraph );
             // parse flow graph
-            config.graphParseGrainCollect( gcamFlowGraph, grainGraph ); 
+            config.graphParseGrainCollect( gcamFlowGraph, grainGraph,
+                                           shouldRebuild ? &mTBBGraphGlobal->mActivityCosts : 0 );
             if( !gcamFlowGraph.topology_valid() ) {
                 ILogger& mainLog = ILogger::getLogger( "main_log" );
                 mainLog.setLevel( ILogger::ERROR );
@@ -290,8 +368,23 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
                 abort();
             }
             // build the tbb graph structure
-            mTBBGraphGlobal = new GcamFlowGraph();
-            config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *mTBBGraphGlobal ); 
+            GcamFlowGraph* flowGraph = new GcamFlowGraph();
+            config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *flowGraph ); 
+            if( shouldRebuild ) {
+                // Report the grain layout before and after weighting by cost using
+                // the same measured costs.
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::NOTICE );
+                mainLog << "Rebuilding flow graph grains weighted by measured activity costs." << endl;
+                config.reportGrainCosts( mTBBGraphGlobal->mGrainGraph, mTBBGraphGlobal->mActivityCosts );
+                config.reportGrainCosts( grainGraph, mTBBGraphGlobal->mActivityCosts );
+                flowGraph->mIsCostWeighted = true;
+                delete mTBBGraphGlobal;
+            }
+            else {
+                flowGraph->mProfileCallsRemaining = config.getNumProfileCalls();
+            }
+            mTBBGraphGlobal = flowGraph;
         }
         return mTBBGraphGlobal;
     }
@@ -337,6 +430,68 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
         return (*mrktIter)->mFlowGraph;
     }
 }
+
+/*!
+ * \brief Build the flow graphs for the given markets up front.
+ * \details Rather than building each market's flow graph the first time it is
+ *          requested, which analyzes the full model flow graph once per market,
+ *          the full flow graph is made once and the sub-graphs for all of the
+ *          markets which do not yet have one are parsed and collected into grains
+ *          in parallel.  The TBB flow graphs are then created serially.  Since the
+ *          dependency graph is static through all model periods the results are
+ *          cached and calling this again in later periods only builds graphs for
+ *          markets which did not have one.  The time spent is reported separately
+ *          from the global graph analysis.
+ * \param aMarketNumbers The market numbers to build flow graphs for.
+ */
+void MarketDependencyFinder::createMarketFlowGraphs( const vector<int>& aMarketNumbers ) {
+    Timer& marketGraphTimer = TimerRegistry::getInstance().getTimer( "market-flow-graphs" );
+    marketGraphTimer.start();
+    
+    // Find the markets which still need a flow graph.  Their orderings are generated
+    // here, serially, since getOrdering caches its results.
+    vector<MarketToDependencyItem*> marketsToBuild;
+    for( vector<int>::const_iterator it = aMarketNumbers.begin(); it != aMarketNumbers.end(); ++it ) {
+        auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( *it ) );
+        CMarketToDepIterator mrktIter = mMarketsToDep.find( marketToDep.get() );
+        if( mrktIter != mMarketsToDep.end() && !(*mrktIter)->mFlowGraph ) {
+            getOrdering( *it );
+            marketsToBuild.push_back( *mrktIter );
+        }
+    }
+    
+    if( !marketsToBuild.empty() ) {
+        GcamParallel config;
+        GcamParallel::FlowGraph gcamFlowGraph;
+        config.makeGCAMFlowGraph( *this, gcamFlowGraph );
+        if( !gcamFlowGraph.topology_valid() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Topological indices not computed." << endl;
+            abort();
+        }
+        
+        // The graph analysis only reads the full flow graph so each market's grains
+        // can be collected concurrently.
+        vector<GcamParallel::FlowGraph> grainGraphs( marketsToBuild.size() );
+        tbb::parallel_for( size_t( 0 ), marketsToBuild.size(), [&]( size_t aIndex ) {
+            config.graphParseGrainCollect( gcamFlowGraph, grainGraphs[ aIndex ], marketsToBuild[ aIndex ]->mCalcList );
+        } );
+        
+        // Building the TBB graph structures logs and so is done serially.
+        for( size_t i = 0; i < marketsToBuild.size(); ++i ) {
+            marketsToBuild[ i ]->mFlowGraph = new GcamFlowGraph();
+            config.makeTBBFlowGraph( grainGraphs[ i ], gcamFlowGraph, *marketsToBuild[ i ]->mFlowGraph );
+        }
+    }
+    marketGraphTimer.stop();
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Built " << marketsToBuild.size() << " of " << aMarketNumbers.size()
+            << " market flow graphs." << endl;
+    marketGraphTimer.print( mainLog, "Market flow graph construction:  " );
+}
 #endif
 
 /*!
@@ -883,6 +1038,8 @@ void MarketDependencyFinder::createTrialsForItem( CItemIterator aItemToReset, Ca
     MarketToDepIterator priceMrktIter = mMarketsToDep.find( marketToDep.get() );
     assert( priceMrktIter != mMarketsToDep.end() );
     MarketToDepIterator demandMrktIter = mMarketsToDep.insert( new MarketToDependencyItem( demandMrkt ) ).first;
+    mTrialMarketPairs[ (*aItemToReset)->mLinkedMarket ] = demandMrkt;
+    mTrialMarketPairs[ demandMrkt ] = (*aItemToReset)->mLinkedMarket;
 
     // The price/demand vertices are obviously implied when the it's corresponding
     // price/demand trial price changes.
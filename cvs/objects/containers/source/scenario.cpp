@@ -98,6 +98,7 @@ Scenario::~Scenario() {
     delete mWorld;
     delete mSolutionInfoParamParser;
     delete mManageStateVars;
+    ManageStateVariables::clearLayoutCache();
     // model time is really a singleton and so don't
     // try to delete it
 }
@@ -263,6 +264,9 @@ void Scenario::completeInit() {
     // Set the valid period vector to false.
     mIsValidPeriod.clear();
     mIsValidPeriod.resize( mModeltime->getmaxper(), false );
+    
+    // The model structure may have changed so the state must be searched for again.
+    ManageStateVariables::clearLayoutCache();
 }
 
 //! Return scenario name.
@@ -284,7 +288,62 @@ bool Scenario::run( const int aSinglePeriod,
 {
     // Avoid accumulating unsolved periods.
     mUnsolvedPeriods.clear();
-    
+
+    // If the single period is RUN_ALL_PERIODS that means to calculate all periods.
+    if( aSinglePeriod == RUN_ALL_PERIODS ){
+        return runPeriods( 0, mModeltime->getmaxper() - 1, aPrintDebugging );
+    }
+    return runPeriods( aSinglePeriod, aSinglePeriod, aPrintDebugging );
+}
+
+/*!
+ * \brief Run the scenario from a given period through the end of the model.
+ * \details Periods before aFirstPeriod which are still valid from a previous
+ *          run are kept as they are and are not solved again. This allows
+ *          callers which only change inputs from aFirstPeriod onward, such as
+ *          a tax path, to avoid recalculating the earlier periods. Any such
+ *          periods which did not solve in the previous run are still reported
+ *          as unsolved.
+ * \param aFirstPeriod The first period to recalculate.
+ * \param aPrintDebugging Whether to print extra debugging files.
+ * \param aFilenameEnding The string to add to the end of the debug output file
+ *        for uniqueness.
+ * \return Whether all model periods are solved successfully.
+ */
+bool Scenario::runFromPeriod( const int aFirstPeriod,
+                              const bool aPrintDebugging,
+                              const string& aFilenameEnding )
+{
+    const int firstPeriod = max( aFirstPeriod, 0 );
+
+    // Only keep the unsolved periods which will not be recalculated.
+    vector<int> keptUnsolvedPeriods;
+    for( vector<int>::const_iterator it = mUnsolvedPeriods.begin(); it != mUnsolvedPeriods.end(); ++it ) {
+        if( *it < firstPeriod && mIsValidPeriod[ *it ] ) {
+            keptUnsolvedPeriods.push_back( *it );
+        }
+    }
+    mUnsolvedPeriods.swap( keptUnsolvedPeriods );
+    const bool keptSuccess = mUnsolvedPeriods.empty();
+
+    return runPeriods( firstPeriod, mModeltime->getmaxper() - 1, aPrintDebugging ) && keptSuccess;
+}
+
+/*!
+ * \brief Calculate a range of model periods.
+ * \details Any invalid periods before the range are calculated first. The
+ *          periods in the range and all periods after it are then invalidated
+ *          and the periods in the range are calculated. The climate model is
+ *          run once all periods have been calculated.
+ * \param aFirstPeriod The first period to calculate.
+ * \param aLastPeriod The last period to calculate.
+ * \param aPrintDebugging Whether to print extra debugging files.
+ * \return Whether all calculated periods solved successfully.
+ */
+bool Scenario::runPeriods( const int aFirstPeriod,
+                           const int aLastPeriod,
+                           const bool aPrintDebugging )
+{
     // Open the debugging files.
     AutoOutputFile XMLDebugFile( "xmlDebugFileName", "debug.xml", aPrintDebugging );
     Tabs tabs;
@@ -304,36 +363,31 @@ bool Scenario::run( const int aSinglePeriod,
 
     bool success = true;
 
-    // If the single period is RUN_ALL_PERIODS that means to calculate all periods. Loop over
-    // time steps and operate model.
-    if( aSinglePeriod == RUN_ALL_PERIODS ){
-        for( int per = 0; per < mModeltime->getmaxper(); per++ ){
-            success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging );
-        }
-    }
-    // Check if the single period is invalid.
-    else if( aSinglePeriod >= mModeltime->getmaxper() ){
+    // Check if the periods are invalid.
+    if( aLastPeriod >= mModeltime->getmaxper() || aFirstPeriod > aLastPeriod ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::ERROR );
-        mainLog << "Invalid single period " << aSinglePeriod << " passed to run method." << endl;
+        mainLog << "Invalid period " << aLastPeriod << " passed to run method." << endl;
         success = false;
     } 
     else {
-        // Run all periods up to the single period which are invalid.
-        for( int per = 0; per < aSinglePeriod; per++ ){
+        // Run all periods up to the first period which are invalid.
+        for( int per = 0; per < aFirstPeriod; per++ ){
             if( !mIsValidPeriod[ per ] ){
                 success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging );
             }
         }
         
-        // Invalidate the period about to be run and all periods past it.
-        for( int per = aSinglePeriod; per < mModeltime->getmaxper(); ++per ){
+        // Invalidate the periods about to be run and all periods past them.
+        for( int per = aFirstPeriod; per < mModeltime->getmaxper(); ++per ){
             mIsValidPeriod[ per ] = false;
         }
 
-        // Now run the requested period. Results past this period will no longer
-        // be valid. Do not attempt to use them!
-        success &= calculatePeriod( aSinglePeriod, *XMLDebugFile, &tabs, aPrintDebugging );
+        // Now run the requested periods. Results past the last period will no
+        // longer be valid. Do not attempt to use them!
+        for( int per = aFirstPeriod; per <= aLastPeriod; ++per ){
+            success &= calculatePeriod( per, *XMLDebugFile, &tabs, aPrintDebugging );
+        }
     }
     
     // Print any unsolved periods.
@@ -634,6 +688,9 @@ void Scenario::printLandAllocatorGraph( const int aPeriod, const bool aPrintValu
 */
 void Scenario::setTax( const GHGPolicy* aTax ){
     mWorld->setTax( aTax );
+    
+    // The policy objects get replaced so the state must be searched for again.
+    ManageStateVariables::clearLayoutCache();
 }
 
 /*! \brief Get the climate model.
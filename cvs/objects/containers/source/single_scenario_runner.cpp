@@ -43,6 +43,8 @@
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/single_scenario_runner.h"
 #include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "containers/include/region_minicam.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/timer.h"
@@ -67,6 +69,7 @@ extern void createDBout();
 /*! \brief Constructor */
 SingleScenarioRunner::SingleScenarioRunner(){
     mXMLDBOutputter = 0;
+    mIsCommonInputParsed = false;
 }
 
 //! Destructor.
@@ -100,49 +103,21 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
         mainLog << "Early warning Java checks failed and database output was requested" << endl;
         abort();
     }
-    // Ensure that a new scenario is created for each run.
-    mScenario.reset( new Scenario );
-
-    // Set the global scenario pointer.
-    // TODO: Remove global scenario pointer.
-    scenario = mScenario.get();
-
-    // Parse the input file.
-    bool success =
-        XMLHelper<void>::parseXML( conf->getFile( "xmlInputFileName" ),
-                                   mScenario.get() );
-    
-    // Check if parsing succeeded.
-    if( !success ){
+    // Parse the base input file and configured scenario components unless
+    // that has already been done by parseCommonInputs.
+    if( !mIsCommonInputParsed && !parseCommonInputs( timer ) ) {
         return false;
     }
-
-    // Fetch the listing of Scenario Components.
-    list<string> scenComponents = conf->getScenarioComponents();
+    // The common inputs may only be used for a single run.
+    mIsCommonInputParsed = false;
+    scenario = mScenario.get();
 
     // Add on any scenario components that were passed in.
-    for( list<string>::const_iterator curr = aScenComponents.begin();
-		curr != aScenComponents.end(); ++curr )
-	{
-        scenComponents.push_back( *curr );
+    if( !parseComponents( aScenComponents ) ) {
+        return false;
     }
     
-    // Iterate over the vector.
-    typedef list<string>::const_iterator ScenCompIter;
     ILogger& mainLog = ILogger::getLogger( "main_log" );
-    for( ScenCompIter currComp = scenComponents.begin();
-		 currComp != scenComponents.end(); ++currComp )
-	{
-        mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Parsing " << *currComp << " scenario component." << endl;
-        success = XMLHelper<void>::parseXML( *currComp, mScenario.get() );
-        
-        // Check if parsing succeeded.
-        if( !success ){
-            return false;
-        }
-    }
-    
     // Override scenario name from data file with that from configuration file
     const string overrideName = conf->getString( "scenarioName" ) + aName;
     if ( !overrideName.empty() ) {
@@ -204,6 +179,82 @@ bool SingleScenarioRunner::runScenarios( const int aSinglePeriod,
     return success;
 }
 
+/*!
+ * \brief Create a new scenario and parse the inputs which are common to every
+ *        run, the base input file and the configured scenario components.
+ * \details The next call to setupScenarios will continue from this scenario,
+ *          only parsing the scenario components passed to it, rather than
+ *          starting over.  This allows a batch of runs which differ only in
+ *          their additional components to share the parsing of the common
+ *          inputs, for instance by forking after this has been called.
+ * \param aTimer The timer used to print out the amount of time spent.
+ * \return Whether the inputs were parsed successfully.
+ */
+bool SingleScenarioRunner::parseCommonInputs( Timer& aTimer ) {
+    const Configuration* conf = Configuration::getInstance();
+    mIsCommonInputParsed = false;
+
+    // Ensure that a new scenario is created for each run.
+    mScenario.reset( new Scenario );
+
+    // Set the global scenario pointer.
+    // TODO: Remove global scenario pointer.
+    scenario = mScenario.get();
+
+    // Input files may optionally be streamed to the scenario a piece at a time
+    // to reduce the memory required to parse them.  Note the world and regions
+    // can be split as they may be parsed many times.
+    const bool streamInput = conf->getBool( "stream-xml-input", false, false );
+    set<string> splitElements;
+    splitElements.insert( World::getXMLNameStatic() );
+    splitElements.insert( RegionMiniCAM::getXMLNameStatic() );
+    
+    // Parse the input file.
+    bool success = streamInput ?
+        XMLHelper<void>::parseXMLStreaming( conf->getFile( "xmlInputFileName" ),
+                                            mScenario.get(), splitElements ) :
+        XMLHelper<void>::parseXML( conf->getFile( "xmlInputFileName" ),
+                                   mScenario.get() );
+    
+    // Check if parsing succeeded.
+    if( !success ){
+        return false;
+    }
+
+    // Parse the listing of Scenario Components.
+    mIsCommonInputParsed = parseComponents( conf->getScenarioComponents() );
+    return mIsCommonInputParsed;
+}
+
+/*!
+ * \brief Parse a list of scenario components into the current scenario.
+ * \param aScenComponents The locations of the scenario components in the order
+ *        in which they should be parsed.
+ * \return Whether all of the components were parsed successfully.
+ */
+bool SingleScenarioRunner::parseComponents( const list<string>& aScenComponents ) {
+    const bool streamInput = Configuration::getInstance()->getBool( "stream-xml-input", false, false );
+    set<string> splitElements;
+    splitElements.insert( World::getXMLNameStatic() );
+    splitElements.insert( RegionMiniCAM::getXMLNameStatic() );
+
+    if( streamInput ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        for( auto currComp = aScenComponents.begin(); currComp != aScenComponents.end(); ++currComp ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Parsing " << *currComp << " scenario component." << endl;
+            
+            // Check if parsing succeeded.
+            if( !XMLHelper<void>::parseXMLStreaming( *currComp, mScenario.get(), splitElements ) ){
+                return false;
+            }
+        }
+        return true;
+    }
+    // Otherwise the files may be read concurrently when parallel is enabled.
+    return XMLHelper<void>::parseXMLFiles( aScenComponents, mScenario.get() );
+}
+
 void SingleScenarioRunner::printOutput( Timer& aTimer ) const {
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
@@ -242,6 +293,7 @@ void SingleScenarioRunner::cleanup() {
     // The current scenario is no longer needed since a new scenario run will be
     // created from scratch the next time a scenario is setup and run.
     mScenario.reset( 0 );
+    mIsCommonInputParsed = false;
     scenario = 0;
 
     // If the XML database was opened then we should close it.
@@ -60,6 +60,7 @@
 #include "containers/include/single_scenario_runner.h"
 #include "policy/include/policy_ghg.h"
 #include "reporting/include/xml_db_outputter.h"
+#include "util/base/include/forked_workers.h"
 
 using namespace std;
 using namespace xercesc;
@@ -78,6 +79,13 @@ TotalPolicyCostCalculator::TotalPolicyCostCalculator( SingleScenarioRunner* aSin
     const Configuration* conf = Configuration::getInstance();
     mGHGName = conf->getString( "AbatedGasForCostCurves", "CO2" );
     mNumPoints = conf->getInt( "numPointsForCO2CostCurve", 5 );
+    mNumWorkers = conf->getInt( "cost-curve-workers", 1 );
+    if( mNumWorkers < 1 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Invalid cost-curve-workers " << mNumWorkers << ", running one trial at a time." << endl;
+        mNumWorkers = 1;
+    }
 }
 
 //! Destructor. Deallocated memory for all the curves created. 
@@ -156,10 +164,6 @@ bool TotalPolicyCostCalculator::calculateAbatementCostCurve() {
 * \author Josh Lurz
 */
 bool TotalPolicyCostCalculator::runTrials(){
-    // Get the number of max periods.
-    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
-    const int maxPeriod = modeltime->getmaxper();
-
     bool success = true;
     const static bool usingRestartPeriod = Configuration::getInstance()->getInt(
         "restart-period", -1 ) != -1;
@@ -167,27 +171,15 @@ bool TotalPolicyCostCalculator::runTrials(){
     if( !usingRestartPeriod ) {
         mSingleScenario->getInternalScenario()->getMarketplace()->store_prices_for_cost_calculation();
     }
+    // The trials are independent of each other so run them at once if requested.
+    if( mNumWorkers > 1 && ForkedWorkers::isEnabled() ) {
+        return runTrialsForked();
+    }
     // Loop through for each point.
     for( int currPoint = mNumPoints - 1; currPoint >= 0; currPoint-- ){
         // Determine the fraction of the full tax this tax will be.
         const double fraction = static_cast<double>( currPoint ) / static_cast<double>( mNumPoints );
-        // Iterate through the regions to set different taxes for each if necessary.
-        // Currently this will set the same for all of them.
-        for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
-            // Vector which will contain taxes for this trial.
-            vector<double> currTaxes( maxPeriod );
-
-            // Set the tax for each year. 
-            for( int per = 0; per < maxPeriod; per++ ){
-                const int year = modeltime->getper_to_yr( per );
-                double origTax = rIter->second->getY( year );
-                currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
-                    origTax * fraction;
-            }
-            // Set the fixed taxes into the world.
-            GHGPolicy tax( mGHGName, rIter->first, currTaxes );
-            mSingleScenario->getInternalScenario()->setTax( &tax );
-        }
+        setTrialTaxes( fraction );
 
         // Create an ending for the output files using the run number.
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -213,6 +205,142 @@ bool TotalPolicyCostCalculator::runTrials(){
     return success;
 }
 
+/*! \brief Run the trials concurrently in forked workers and store the
+*          abatement curves.
+* \details Each trial is run in a forked copy of the process which starts from
+*          the solved policy run and reports back whether it solved followed by
+*          the emissions quantity and tax by region and period. The curves are
+*          then rebuilt from these values. A trial whose worker failed to report
+*          is run again in this process.
+* \return Whether all model runs completed successfully.
+*/
+bool TotalPolicyCostCalculator::runTrialsForked(){
+    Scenario* scenario = mSingleScenario->getInternalScenario();
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int maxPeriod = modeltime->getmaxper();
+    const static bool usingRestartPeriod = Configuration::getInstance()->getInt(
+        "restart-period", -1 ) != -1;
+
+    vector<ForkedWorkers::Task> tasks;
+    for( int currPoint = mNumPoints - 1; currPoint >= 0; currPoint-- ){
+        tasks.push_back( [this, currPoint, scenario, modeltime, maxPeriod]() {
+            // Start from the original solved market prices as the serial
+            // trials do.
+            if( !usingRestartPeriod ) {
+                scenario->getMarketplace()->restore_prices_for_cost_calculation();
+            }
+            setTrialTaxes( static_cast<double>( currPoint ) / static_cast<double>( mNumPoints ) );
+
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Starting cost curve point run number " << currPoint << "." << endl;
+
+            // Debugging output is not written since the workers would all write
+            // to the same file.
+            const bool success = scenario->run( Scenario::RUN_ALL_PERIODS, false,
+                                                util::toString( currPoint ) );
+
+            RegionCurves emissionsQCurves = scenario->getEmissionsQuantityCurves( mGHGName );
+            RegionCurves emissionsTCurves = scenario->getEmissionsPriceCurves( mGHGName );
+            vector<double> values( 1, success ? 1 : 0 );
+            for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
+                for( int per = 0; per < maxPeriod; per++ ){
+                    const int year = modeltime->getper_to_yr( per );
+                    values.push_back( emissionsQCurves[ rIter->first ]->getY( year ) );
+                    values.push_back( emissionsTCurves[ rIter->first ]->getY( year ) );
+                }
+            }
+            for( RegionCurvesIterator rIter = emissionsQCurves.begin(); rIter != emissionsQCurves.end(); ++rIter ){
+                delete rIter->second;
+            }
+            for( RegionCurvesIterator rIter = emissionsTCurves.begin(); rIter != emissionsTCurves.end(); ++rIter ){
+                delete rIter->second;
+            }
+            return values;
+        } );
+    }
+
+    vector<vector<double> > results = ForkedWorkers::run( tasks, mNumWorkers );
+
+    bool success = true;
+    const size_t numValues = 1 + 2 * maxPeriod * mEmissionsTCurves[ mNumPoints ].size();
+    for( size_t i = 0; i < tasks.size(); ++i ){
+        const int currPoint = mNumPoints - 1 - static_cast<int>( i );
+        if( results[ i ].size() != numValues ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Cost curve point run number " << currPoint
+                    << " did not complete in a worker, running it again." << endl;
+            results[ i ] = tasks[ i ]();
+        }
+        success &= results[ i ][ 0 ] != 0;
+
+        // Rebuild the curves from the values reported by the worker.
+        size_t index = 1;
+        for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
+            mEmissionsQCurves[ currPoint ][ rIter->first ] =
+                createYearCurve( results[ i ], index, mGHGName + " emissions curve", "emissions quantity" );
+            mEmissionsTCurves[ currPoint ][ rIter->first ] =
+                createYearCurve( results[ i ], index + 1, mGHGName + " emissions tax curve", "emissions tax" );
+            index += 2 * maxPeriod;
+        }
+    }
+    return success;
+}
+
+/*! \brief Set the fixed taxes for a trial into the world.
+* \details The tax for each region and period is set to a fraction of the tax
+*          in the policy run.
+* \param aFraction The fraction of the full tax to use.
+*/
+void TotalPolicyCostCalculator::setTrialTaxes( const double aFraction ){
+    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
+    const int maxPeriod = modeltime->getmaxper();
+
+    // Iterate through the regions to set different taxes for each if necessary.
+    // Currently this will set the same for all of them.
+    for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
+        // Vector which will contain taxes for this trial.
+        vector<double> currTaxes( maxPeriod );
+
+        // Set the tax for each year. 
+        for( int per = 0; per < maxPeriod; per++ ){
+            const int year = modeltime->getper_to_yr( per );
+            double origTax = rIter->second->getY( year );
+            currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
+                origTax * aFraction;
+        }
+        // Set the fixed taxes into the world.
+        GHGPolicy tax( mGHGName, rIter->first, currTaxes );
+        mSingleScenario->getInternalScenario()->setTax( &tax );
+    }
+}
+
+/*! \brief Create a curve by model year from values reported by a worker.
+* \param aValues The reported values which hold the quantity and tax
+*        interleaved for each period.
+* \param aFirstIndex The index of the value for the first period.
+* \param aTitle The title of the curve.
+* \param aYLabel The label of the y axis.
+* \return The curve which the caller is responsible for deallocating.
+*/
+const Curve* TotalPolicyCostCalculator::createYearCurve( const vector<double>& aValues,
+                                                         const size_t aFirstIndex,
+                                                         const string& aTitle,
+                                                         const string& aYLabel )
+{
+    const Modeltime* modeltime = scenario->getModeltime();
+    ExplicitPointSet* points = new ExplicitPointSet();
+    for( int per = 0; per < modeltime->getmaxper(); per++ ){
+        points->addPoint( new XYDataPoint( modeltime->getper_to_yr( per ), aValues[ aFirstIndex + 2 * per ] ) );
+    }
+    Curve* curve = new PointSetCurve( points );
+    curve->setTitle( aTitle );
+    curve->setXAxisLabel( "year" );
+    curve->setYAxisLabel( aYLabel );
+    return curve;
+}
+
 /*! \brief Create a cost curve for each period and region.
 * \details Using the cost curves generated by the trials, generate and stored a set of cost
 * curves by period and region.
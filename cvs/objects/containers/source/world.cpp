@@ -369,6 +369,14 @@ void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IAc
     // do the model calculation
     aWorkGraph->mHead.try_put( tbb::flow::continue_msg() );
     aWorkGraph->mTBBFlowGraph.wait_for_all();
+    
+    // Once enough calculations have been profiled switch to the global flow graph
+    // rebuilt with grains weighted by the measured costs.
+    if( aWorkGraph->mProfileCallsRemaining > 0 && --aWorkGraph->mProfileCallsRemaining == 0
+        && aWorkGraph == mTBBGraphGlobal )
+    {
+        mTBBGraphGlobal = scenario->getMarketplace()->getDependencyFinder()->getFlowGraph();
+    }
 
 #ifdef GNU_SOURCE
     feenableexcept(except);
@@ -57,6 +57,7 @@
 #include "functions/include/function_utils.h"
 #include "marketplace/include/cached_market.h"
 #include "technologies/include/icapture_component.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 using namespace std;
 using namespace xercesc;
@@ -164,6 +165,8 @@ void NonCO2Emissions::copyGHGParameters( const AGHG* aPrevGHG ){
         // If there was no match, then copy old object forward
         if( !isAMatch ) {
             mEmissionsControls.push_back( (*prevControlIt)->clone() );
+            // The new control may have state of its own which will need to be found.
+            ManageStateVariables::clearLayoutCache();
         }
     }
 }
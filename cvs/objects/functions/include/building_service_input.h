@@ -46,6 +46,7 @@
 */
 
 #include "util/base/include/definitions.h"
+#include <memory>
 
 #include "functions/include/inested_input.h"
 #include "util/base/include/value.h"
@@ -54,6 +55,7 @@
 class IFunction;
 class BuildingNodeInput;
 class SatiationDemandFunction;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -323,6 +325,10 @@ protected:
         //! Satiation demand function.
         DEFINE_VARIABLE( CONTAINER, "satiation-demand-function", mSatiationDemandFunction, SatiationDemandFunction* )
     )
+
+    //! A pre-located market which has been cached from the marketplace to get
+    //! the price and add demands to.
+    std::auto_ptr<CachedMarket> mCachedMarket;
     
     void copy( const BuildingServiceInput& aInput );
 };
@@ -50,6 +50,7 @@
 #include <memory>
 
 class Tabs;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -160,6 +161,12 @@ protected:
         //! The C coef associated with mFuelName
         DEFINE_VARIABLE( SIMPLE, "fuel-C-coef", mCachedCCoef, double )
     )
+
+    //! A pre-located market for the tax fraction of this input.
+    std::auto_ptr<CachedMarket> mCachedMarket;
+
+    //! A pre-located market for the CO2 price.
+    std::auto_ptr<CachedMarket> mCachedCO2Market;
 };
 
 #endif // _CTAX_INPUT_H_
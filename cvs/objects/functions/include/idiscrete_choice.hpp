@@ -43,6 +43,7 @@
  * \brief IDiscreteChoice class declaration file
  * \author Robert Link
  */
+#include <vector>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
@@ -128,6 +129,23 @@ public:
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Compute the unnormalized shares of a set of competing options at once.
+     * \details Gives the same results as calling calcUnnormalizedShare for each
+     *          option but with a single virtual call and with the terms common to
+     *          all options hoisted out of a simple loop that the compiler is able
+     *          to vectorize.
+     * \param aShareWeights The weighting term of each option.
+     * \param aValues The value of each option in the same order as aShareWeights.
+     * \param aPeriod The current model period.
+     * \param aLogShares The log of the unnormalized share of each option.  This
+     *                   will be resized to the number of options.
+     */
+    virtual void calcUnnormalizedShares( const std::vector<double>& aShareWeights,
+                                         const std::vector<double>& aValues,
+                                         const int aPeriod,
+                                         std::vector<double>& aLogShares ) const = 0;
+
     /*!
      * \brief Compute the mean value according the the discrete choice function's
      *        parameterization.
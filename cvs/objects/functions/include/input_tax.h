@@ -53,6 +53,7 @@
 #include "util/base/include/time_vector.h"
 
 class Tabs;
+class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -171,6 +172,19 @@ protected:
 
     //! Stash the current sector name for use in setPhysicalDemand
     std::string mSectorName;
+
+    //! Whether the policy market for this input is share based, i.e. the
+    //! demand should be divided by the output of mSectorName.  Looked up in
+    //! initCalc.
+    bool mIsShareBased;
+
+    //! A pre-located market which has been cached from the marketplace to get
+    //! the price and add demands to.
+    std::auto_ptr<CachedMarket> mCachedMarket;
+
+    //! A pre-located market for mSectorName used to get the sector output
+    //! when mIsShareBased.
+    std::auto_ptr<CachedMarket> mCachedSectorMarket;
 private:
     const static std::string XML_REPORTING_NAME; //!< tag name for reporting xml db 
 };
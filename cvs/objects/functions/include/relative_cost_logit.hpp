@@ -95,6 +95,11 @@ public:
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const;
 
+    virtual void calcUnnormalizedShares( const std::vector<double>& aShareWeights,
+                                         const std::vector<double>& aValues,
+                                         const int aPeriod,
+                                         std::vector<double>& aLogShares ) const;
+
     virtual double calcAverageValue( const double aUnnormalizedShareSum,
                                      const double aLogShareFac,
                                      const int aPeriod ) const;
@@ -188,6 +188,37 @@ double AbsoluteCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
     return logShareWeight + mLogitExponent[ aPeriod ] * aValue / mBaseValue;
 }
 
+/*!
+ * \brief Absolute cost logit discrete choice function for a set of options.
+ * \details The batched equivalent of calcUnnormalizedShare.
+ * \param aShareWeights share weights for the choices.
+ * \param aValues values for the choices.
+ * \param aPeriod model time period for the calculation.
+ * \param aLogShares log of the unnormalized shares.
+ */
+void AbsoluteCostLogit::calcUnnormalizedShares( const std::vector<double>& aShareWeights,
+                                                const std::vector<double>& aValues,
+                                                const int aPeriod,
+                                                std::vector<double>& aLogShares ) const
+{
+    /*!
+     * \pre A valid base cost has been set.
+     */
+    assert( mBaseValue > 0 );
+    assert( aShareWeights.size() == aValues.size() );
+    
+    const double minInf = -std::numeric_limits<double>::infinity();
+    const double logitExponent = mLogitExponent[ aPeriod ];
+    const double baseValue = mBaseValue;
+    const size_t numOptions = aValues.size();
+    aLogShares.resize( numOptions );
+    for( size_t i = 0; i < numOptions; ++i ) {
+        // Zero share weight implies no share which is signaled by negative infinity.
+        const double logShareWeight = aShareWeights[ i ] > 0.0 ? log( aShareWeights[ i ] ) : minInf;
+        aLogShares[ i ] = logShareWeight + logitExponent * aValues[ i ] / baseValue;
+    }
+}
+
 double AbsoluteCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
                                            const double aLogShareFac,
                                            const int aPeriod ) const
@@ -47,6 +47,7 @@
 #include "functions/include/ctax_input.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "containers/include/market_dependency_finder.h"
 #include "containers/include/iinfo.h"
@@ -186,6 +187,12 @@ void CTaxInput::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mCachedCCoef = FunctionUtils::getCO2Coef( aRegionName, mFuelName, aPeriod );
+    
+    // Resolve the markets once here so that getPrice does not need to look
+    // them up during World.calc.
+    Marketplace* marketplace = scenario->getMarketplace();
+    mCachedMarket = marketplace->locateMarket( mName, aRegionName, aPeriod );
+    mCachedCO2Market = marketplace->locateMarket( "CO2", aRegionName, aPeriod );
 }
 
 void CTaxInput::copyParam( const IInput* aInput,
@@ -234,9 +241,17 @@ double CTaxInput::getPrice( const string& aRegionName,
     // Conversion from teragrams of carbon per EJ to metric tons of carbon per GJ
     const double CVRT_TG_MT = 1e-3;
     // A high tax decreases demand.
-    const Marketplace* marketplace = scenario->getMarketplace();
-    double taxFraction = marketplace->getPrice( mName, aRegionName, aPeriod, true );
-    double ctax = marketplace->getPrice( "CO2", aRegionName, aPeriod, false );
+    double taxFraction;
+    double ctax;
+    if( mCachedMarket.get() ) {
+        taxFraction = mCachedMarket->getPrice( mName, aRegionName, aPeriod, true );
+        ctax = mCachedCO2Market->getPrice( "CO2", aRegionName, aPeriod, false );
+    }
+    else {
+        const Marketplace* marketplace = scenario->getMarketplace();
+        taxFraction = marketplace->getPrice( mName, aRegionName, aPeriod, true );
+        ctax = marketplace->getPrice( "CO2", aRegionName, aPeriod, false );
+    }
     
     // note we need to perform some unit conversions since C prices and technology
     // costs in different units
@@ -47,6 +47,7 @@
 #include "functions/include/input_subsidy.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "technologies/include/icapture_component.h"
 #include "functions/include/icoefficient.h"
@@ -93,7 +94,8 @@ const string& InputSubsidy::getXMLReportingName() const{
 }
 
 //! Constructor
-InputSubsidy::InputSubsidy()
+InputSubsidy::InputSubsidy():
+mIsShareBased( false )
 {
     TechVectorParseHelper<Value>::setDefaultValue( Value( 1.0 ), mAdjustedCoefficients );
 }
@@ -113,7 +115,8 @@ InputSubsidy::~InputSubsidy() {
  *          allocated memory.
  * \param aOther subsidy input from which to copy.
  */
-InputSubsidy::InputSubsidy( const InputSubsidy& aOther )
+InputSubsidy::InputSubsidy( const InputSubsidy& aOther ):
+mIsShareBased( false )
 {
     MiniCAMInput::copy( aOther );
     // Do not clone the input coefficient as the calculated
@@ -208,6 +211,15 @@ void InputSubsidy::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+
+    // Resolve the markets once here so that setPhysicalDemand does not need
+    // to look them up during World.calc.
+    Marketplace* marketplace = scenario->getMarketplace();
+    const IInfo* marketInfo = marketplace->getMarketInfo( mName, aRegionName, 0, true );
+    mIsShareBased = marketInfo && marketInfo->hasValue( "isShareBased" ) &&
+                    marketInfo->getBoolean( "isShareBased", true );
+    mCachedMarket = marketplace->locateMarket( mName, aRegionName, aPeriod );
+    mCachedSectorMarket = marketplace->locateMarket( mSectorName, aRegionName, aPeriod );
 }
 
 void InputSubsidy::copyParam( const IInput* aInput,
@@ -243,16 +255,10 @@ void InputSubsidy::setPhysicalDemand( double aPhysicalDemand,
                                      const int aPeriod )
 {
 
-    Marketplace* marketplace = scenario->getMarketplace();
-    IInfo* marketInfo = marketplace->getMarketInfo( mName, aRegionName, 0, true );
-
     // If subsidy is shared based, then divide by sector output.
-    // Check if marketInfo exists and has the "isShareBased" boolean.
-    if( marketInfo && marketInfo->hasValue( "isShareBased" ) ){
-        if( marketInfo->getBoolean( "isShareBased", true ) ){
-            // Each share is additive
-            aPhysicalDemand/= marketplace->getDemand( mSectorName, aRegionName, aPeriod );
-        }
+    if( mIsShareBased ){
+        // Each share is additive
+        aPhysicalDemand/= mCachedSectorMarket->getDemand( mSectorName, aRegionName, aPeriod );
     }
     // mPhysicalDemand can be a share if subsidy is share based.
     mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
@@ -260,8 +266,8 @@ void InputSubsidy::setPhysicalDemand( double aPhysicalDemand,
     // This is so solver can use the excess demand to determine
     // whether to increase or decrease a subsidy. 
     // Each technology share is additive.
-    marketplace->addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
-                              aPeriod, true );
+    mCachedMarket->addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
 }
@@ -285,7 +291,9 @@ double InputSubsidy::getPrice( const string& aRegionName,
     // Return negative of price to reflect subsidy for portfolio
     // standard market.
     // A high subsidy increases supply.
-    return - scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    return - ( mCachedMarket.get() ?
+        mCachedMarket->getPrice( mName, aRegionName, aPeriod, true ) :
+        scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true ) );
 }
 
 void InputSubsidy::setPrice( const string& aRegionName,
@@ -47,6 +47,7 @@
 #include "functions/include/input_tax.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 #include "util/base/include/xml_helper.h"
 #include "technologies/include/icapture_component.h"
 #include "functions/include/icoefficient.h"
@@ -93,7 +94,8 @@ const string& InputTax::getXMLReportingName() const{
 }
 
 //! Constructor
-InputTax::InputTax()
+InputTax::InputTax():
+mIsShareBased( false )
 {
     TechVectorParseHelper<Value>::setDefaultValue( Value( 1.0 ), mAdjustedCoefficients );
 }
@@ -113,7 +115,8 @@ InputTax::~InputTax() {
  *          allocated memory.
  * \param aOther tax input from which to copy.
  */
-InputTax::InputTax( const InputTax& aOther )
+InputTax::InputTax( const InputTax& aOther ):
+mIsShareBased( false )
 {
     MiniCAMInput::copy( aOther );
     // Do not clone the input coefficient as the calculated
@@ -208,6 +211,15 @@ void InputTax::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+
+    // Resolve the markets once here so that setPhysicalDemand does not need
+    // to look them up during World.calc.
+    Marketplace* marketplace = scenario->getMarketplace();
+    const IInfo* marketInfo = marketplace->getMarketInfo( mName, aRegionName, 0, true );
+    mIsShareBased = marketInfo && marketInfo->hasValue( "isShareBased" ) &&
+                    marketInfo->getBoolean( "isShareBased", true );
+    mCachedMarket = marketplace->locateMarket( mName, aRegionName, aPeriod );
+    mCachedSectorMarket = marketplace->locateMarket( mSectorName, aRegionName, aPeriod );
 }
 
 void InputTax::copyParam( const IInput* aInput,
@@ -243,22 +255,16 @@ void InputTax::setPhysicalDemand( double aPhysicalDemand,
                                      const int aPeriod )
 {
 
-    Marketplace* marketplace = scenario->getMarketplace();
-    IInfo* marketInfo = marketplace->getMarketInfo( mName, aRegionName, 0, true );
-
     // If tax is shared based, then divide by sector output.
-    // Check if marketInfo exists and has the "isShareBased" boolean.
-    if( marketInfo && marketInfo->hasValue( "isShareBased" ) ){
-        if( marketInfo->getBoolean( "isShareBased", true ) ){
-            // Each share is additive
-            aPhysicalDemand/= marketplace->getDemand( mSectorName, aRegionName, aPeriod );
-        }
+    if( mIsShareBased ){
+        // Each share is additive
+        aPhysicalDemand/= mCachedSectorMarket->getDemand( mSectorName, aRegionName, aPeriod );
     }
     // mPhysicalDemand can be a share if tax is share based.
     mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
     // Each technology share is additive.
-    marketplace->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
-                              aPeriod, true );
+    mCachedMarket->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
 }
@@ -280,7 +286,9 @@ double InputTax::getPrice( const string& aRegionName,
                               const int aPeriod ) const
 {
     // A high tax decreases demand.
-    return scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    return ( mCachedMarket.get() ?
+        mCachedMarket->getPrice( mName, aRegionName, aPeriod, true ) :
+        scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true ) );
 }
 
 void InputTax::setPrice( const string& aRegionName,
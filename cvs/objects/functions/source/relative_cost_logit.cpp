@@ -185,6 +185,33 @@ double RelativeCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
     // logit and the absolute value logit.
 }
 
+/*!
+ * \brief Relative value logit discrete choice function for a set of options.
+ * \details The batched equivalent of calcUnnormalizedShare.
+ * \param aShareWeights share weights for the choices.
+ * \param aValues values for the choices.
+ * \param aPeriod model time period for the calculation.
+ * \param aLogShares log of the unnormalized shares.
+ */
+void RelativeCostLogit::calcUnnormalizedShares( const std::vector<double>& aShareWeights,
+                                                const std::vector<double>& aValues,
+                                                const int aPeriod,
+                                                std::vector<double>& aLogShares ) const
+{
+    assert( aShareWeights.size() == aValues.size() );
+    
+    const double minInf = -std::numeric_limits<double>::infinity();
+    const double logitExponent = mLogitExponent[ aPeriod ];
+    const double minValue = getMinValueThreshold();
+    const size_t numOptions = aValues.size();
+    aLogShares.resize( numOptions );
+    for( size_t i = 0; i < numOptions; ++i ) {
+        // Zero share weight implies no share which is signaled by negative infinity.
+        const double logShareWeight = aShareWeights[ i ] > 0.0 ? log( aShareWeights[ i ] ) : minInf;
+        aLogShares[ i ] = logShareWeight + logitExponent * log( std::max( aValues[ i ], minValue ) );
+    }
+}
+
 double RelativeCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
                                            const double aLogShareFac,
                                            const int aPeriod ) const
@@ -286,6 +286,13 @@ public:
      */
     double getProfitRate( const int aPeriod ) const;
 
+    /*!
+     * \brief Get the share weight for this land item.
+     * \param aPeriod Model period.
+     * \return The share weight in the given model period.
+     */
+    double getShareWeight( const int aPeriod ) const;
+
     /*!
      * \brief Set the rate at which the carbon price is expected to increase
      * \details This method sets expectations about the carbon price to be
@@ -323,9 +330,12 @@ public:
      *          modified logit from the energy system.
      * \param aRegionName Name of the containing region.
      * \param aChoiceFnAbove The discrete choice function from the level above
-     *                       to calculate shares at this node.
+     *                       to calculate shares at this node.  If null the
+     *                       unnormalized share is not calculated and the
+     *                       caller is expected to calculate it from the
+     *                       profit rate and share weight.
      * \param aPeriod Model period.
-     * \return The unnormalized share.
+     * \return The unnormalized share, or zero if aChoiceFnAbove is null.
      * \author Kate Calvin
      */
     virtual double calcLandShares( const std::string& aRegionName,
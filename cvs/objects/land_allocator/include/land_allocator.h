@@ -48,6 +48,8 @@
 #include "land_allocator/include/land_node.h"
 #include "util/base/include/ivisitable.h"
 
+class LandLeaf;
+
 class IInfo;
 
 /*! 
@@ -127,6 +129,9 @@ public:
     virtual void calcLUCEmissions( const std::string& aRegionName,
                                    const int aPeriod, const int aEndYear,
                                    const bool aStoreFullEmiss );
+
+    virtual void calculateNodeProfitRates( const std::string& aRegionName,
+                                           const int aPeriod );
                               
     virtual ALandAllocatorItem* findProductLeaf( const std::string& aProductName );
 protected:
@@ -155,6 +160,29 @@ protected:
     )
 
 private:
+    //! All land nodes in the tree, including this one, in depth first order.
+    //! The land calculations loop over these rather than recursing the tree.
+    std::vector<LandNode*> mFlatNodes;
+
+    //! All items in the tree other than this one in depth first order which is
+    //! the order the recursive calculations would visit them.
+    std::vector<ALandAllocatorItem*> mFlatItems;
+
+    //! The index into mFlatNodes of the parent of each item in mFlatItems.
+    std::vector<int> mFlatItemParent;
+
+    //! The index into mFlatNodes of each item in mFlatItems which is a node,
+    //! or -1 for leaves.
+    std::vector<int> mFlatItemNode;
+
+    //! All nodes in the tree which have a node carbon calc.
+    std::vector<LandNode*> mFlatCarbonNodes;
+
+    //! All leaves in the tree in depth first order.
+    std::vector<LandLeaf*> mFlatLeaves;
+
+    void flattenTree( ALandAllocatorItem* aItem, const int aParentIndex );
+
     void calibrateLandAllocator( const std::string& aRegionName, const int aPeriod );
 
     void checkLandArea( const std::string& aRegionName, const int aPeriod );
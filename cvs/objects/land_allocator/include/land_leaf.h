@@ -118,6 +118,12 @@ public:
                                    const int aPeriod, const int aEndYear,
                                    const bool aStoreFullEmiss );
 
+    void calcLeafLUCEmissions( const int aPeriod, const int aEndYear,
+                               const bool aStoreFullEmiss );
+
+    void addLUCEmissionsToMarket( const std::string& aRegionName,
+                                  const int aPeriod ) const;
+
     virtual double getLandAllocation( const std::string& aProductName,
                                       const int aPeriod ) const;
 
@@ -134,6 +134,11 @@ public:
     virtual void calcLUCEmissions( const std::string& aRegionName,
                                    const int aYear, const int aEndYear,
                                    const bool aStoreFullEmiss );
+
+    bool hasNodeCarbonCalc() const;
+
+    void calcNodeLUCEmissions( const int aPeriod, const int aEndYear,
+                               const bool aStoreFullEmiss );
     
     virtual double getLandAllocation( const std::string& aProductName,
                                       const int aPeriod ) const;
@@ -154,6 +159,10 @@ public:
     
 	virtual bool isUnmanagedLandLeaf( )  const;
 
+    void calcChildShares( const int aPeriod );
+
+    void calcNodeProfitRate( const int aPeriod );
+
     virtual void accept( IVisitor* aVisitor, 
                          const int aPeriod ) const;
 
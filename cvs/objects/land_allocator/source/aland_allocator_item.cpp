@@ -100,6 +100,15 @@ double ALandAllocatorItem::getProfitRate( const int aPeriod ) const {
     return mProfitRate[ aPeriod ];
 }
 
+/*!
+ * \brief Returns the share weight for the specified period.
+ * \param aPeriod The period to get the share weight for.
+ * \return The share weight of this item for the specified period.
+ */
+double ALandAllocatorItem::getShareWeight( const int aPeriod ) const {
+    return mShareWeight[ aPeriod ];
+}
+
 /*!
  * \brief Returns the share for the specified period.
  * \param aPeriod The period to get the rate for.
@@ -41,7 +41,13 @@
 #include "util/base/include/definitions.h"
 #include "util/base/include/xml_helper.h"
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#endif
+
 #include "land_allocator/include/land_allocator.h"
+#include "land_allocator/include/land_leaf.h"
+#include "marketplace/include/marketplace.h"
 #include "containers/include/scenario.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/model_time.h"
@@ -152,6 +158,47 @@ void LandAllocator::completeInit( const string& aRegionName,
 
     // Set the soil time scale
     setSoilTimeScale( mSoilTimeScale );
+
+    // The structure of the tree is now fixed so flatten it for calc.
+    mFlatNodes.clear();
+    mFlatItems.clear();
+    mFlatItemParent.clear();
+    mFlatItemNode.clear();
+    mFlatCarbonNodes.clear();
+    mFlatLeaves.clear();
+    mFlatNodes.push_back( this );
+    for( unsigned int i = 0; i < mChildren.size(); ++i ) {
+        flattenTree( mChildren[ i ], 0 );
+    }
+    for( size_t i = 0; i < mFlatNodes.size(); ++i ) {
+        if( mFlatNodes[ i ]->hasNodeCarbonCalc() ) {
+            mFlatCarbonNodes.push_back( mFlatNodes[ i ] );
+        }
+    }
+}
+
+/*!
+ * \brief Add an item and everything below it to the flattened tree.
+ * \details Items are added in depth first order so that every node comes before
+ *          its children.  Looping over the nodes in reverse therefore visits
+ *          children before their parents.
+ * \param aItem The item to add.
+ * \param aParentIndex The index of the parent of aItem in mFlatNodes.
+ */
+void LandAllocator::flattenTree( ALandAllocatorItem* aItem, const int aParentIndex ) {
+    mFlatItems.push_back( aItem );
+    mFlatItemParent.push_back( aParentIndex );
+    if( aItem->getType() != eNode ) {
+        mFlatItemNode.push_back( -1 );
+        mFlatLeaves.push_back( static_cast<LandLeaf*>( aItem ) );
+        return;
+    }
+    const int nodeIndex = static_cast<int>( mFlatNodes.size() );
+    mFlatItemNode.push_back( nodeIndex );
+    mFlatNodes.push_back( static_cast<LandNode*>( aItem ) );
+    for( size_t i = 0; i < aItem->getNumChildren(); ++i ) {
+        flattenTree( aItem->getChildAt( i ), nodeIndex );
+    }
 }
 
 
@@ -308,7 +355,12 @@ double LandAllocator::calcLandShares( const string& aRegionName,
     // First set value of unmanaged land leaves
     setUnmanagedLandProfitRate( aRegionName, mUnManagedLandValue, aPeriod );
 
-    LandNode::calcLandShares( aRegionName, aChoiceFnAbove, aPeriod );
+    // Calculate the shares within each node starting from the bottom of the tree
+    // so that the profit rates of child nodes are available to their parents.
+    // Leaves do not calculate their own shares so they can be skipped.
+    for( int nodeIndex = static_cast<int>( mFlatNodes.size() ) - 1; nodeIndex >= 0; --nodeIndex ) {
+        mFlatNodes[ nodeIndex ]->calcChildShares( aPeriod );
+    }
  
     // This is the root node so its share is 100%.
     mShare[ aPeriod ] = 1;
@@ -318,8 +370,35 @@ double LandAllocator::calcLandShares( const string& aRegionName,
 void LandAllocator::calcLandAllocation( const string& aRegionName,
                                             const double aLandAllocationAbove,
                                             const int aPeriod ){
-    for ( unsigned int i = 0; i < mChildren.size(); ++i ){
-        mChildren[ i ]->calcLandAllocation( aRegionName, mLandAllocation[ aPeriod ], aPeriod );
+    // Visit the items in the same order as recursing the tree so that any
+    // demands the leaves add are accumulated in the same order.  A node only
+    // passes its allocation down so it is calculated here directly.  Note the
+    // allocation of each node is kept locally since partial derivatives may
+    // calculate this region concurrently.
+    vector<double> nodeLandAllocation( mFlatNodes.size() );
+    nodeLandAllocation[ 0 ] = mLandAllocation[ aPeriod ];
+    for( size_t i = 0; i < mFlatItems.size(); ++i ){
+        const double landAllocationAbove = nodeLandAllocation[ mFlatItemParent[ i ] ];
+        const int nodeIndex = mFlatItemNode[ i ];
+        if( nodeIndex == -1 ){
+            mFlatItems[ i ]->calcLandAllocation( aRegionName, landAllocationAbove, aPeriod );
+        }
+        else {
+            const double share = mFlatItems[ i ]->getShare( aPeriod );
+            assert( share >= 0.0 && share <= 1.0 );
+            nodeLandAllocation[ nodeIndex ] = landAllocationAbove > 0.0 && share > 0.0 ?
+                landAllocationAbove * share : 0.0;
+        }
+    }
+}
+
+void LandAllocator::calculateNodeProfitRates( const string& aRegionName,
+                                              const int aPeriod )
+{
+    // Leaves do not calculate a node profit rate so only loop over the nodes,
+    // children first.
+    for( int nodeIndex = static_cast<int>( mFlatNodes.size() ) - 1; nodeIndex >= 0; --nodeIndex ) {
+        mFlatNodes[ nodeIndex ]->calcNodeProfitRate( aPeriod );
     }
 }
 
@@ -327,10 +406,42 @@ void LandAllocator::calcLUCEmissions( const string& aRegionName, const int aPeri
                                       const int aEndYear, const bool aStoreFullEmiss )
 {
     // Calculate emissions for all years in this model period.  Note that in
-    // period 0 historical emissions are also calculated.
-    for ( unsigned int i = 0; i < mChildren.size(); ++i ){
-        mChildren[ i ]->calcLUCEmissions( aRegionName, aPeriod, aEndYear, aStoreFullEmiss );
-    } 
+    // period 0 historical emissions are also calculated.  The carbon calc of each
+    // leaf only depends on its own land allocation so rather than recursing the
+    // tree they are calculated as a single batch.  Node carbon calcs set the
+    // emissions into the carbon calcs of the leaves below them so they must all
+    // be calculated first.
+    bool isConcurrent = false;
+#if GCAM_PARALLEL_ENABLED
+    // Each worker thread is assigned its own copy of the model state during partial
+    // derivative calculations so we may only spread the calc across threads when
+    // working on the base state.
+    isConcurrent = !Marketplace::isDerivativeCalc();
+    if( isConcurrent ) {
+        tbb::parallel_for( size_t( 0 ), mFlatCarbonNodes.size(), [&]( size_t aIndex ) {
+            mFlatCarbonNodes[ aIndex ]->calcNodeLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
+        } );
+        tbb::parallel_for( size_t( 0 ), mFlatLeaves.size(), [&]( size_t aIndex ) {
+            mFlatLeaves[ aIndex ]->calcLeafLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
+        } );
+    }
+#endif
+    if( !isConcurrent ) {
+        for( size_t i = 0; i < mFlatCarbonNodes.size(); ++i ) {
+            mFlatCarbonNodes[ i ]->calcNodeLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
+        }
+        for( size_t i = 0; i < mFlatLeaves.size(); ++i ) {
+            mFlatLeaves[ i ]->calcLeafLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
+        }
+    }
+
+    // The marketplace is not safe to update concurrently so add the emissions to
+    // the carbon market afterwards in the same order as the recursive calc did.
+    if( !aStoreFullEmiss ) {
+        for( size_t i = 0; i < mFlatLeaves.size(); ++i ) {
+            mFlatLeaves[ i ]->addLUCEmissionsToMarket( aRegionName, aPeriod );
+        }
+    }
 }
 
 
@@ -426,6 +426,11 @@ double LandLeaf::calcLandShares( const string& aRegionName,
                                  IDiscreteChoice* aChoiceFnAbove,
                                  const int aPeriod )
 {
+    // The parent node will calculate the shares of all of its children at once.
+    if( !aChoiceFnAbove ) {
+        return 0;
+    }
+    
     // Calculate the unnormalized share for this leaf
     // The unnormalized share is used by the parent node to 
     // calculate the leaf's share of the parent's land
@@ -486,17 +491,44 @@ void LandLeaf::calcLUCEmissions( const string& aRegionName,
                                  const int aPeriod, const int aEndYear,
                                  const bool aStoreFullEmiss )
 {
-    // Calculate the amount of emissions attributed to land use change in the current period
-    mLastCalcCO2Value = mCarbonContentCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
+    calcLeafLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
 
     // Add emissions to the carbon market.
     if ( !aStoreFullEmiss ) {
-        Marketplace* marketplace = scenario->getMarketplace();
-        marketplace->addToDemand( "CO2_LUC", aRegionName,
-                                  mLastCalcCO2Value, aPeriod, false );
+        addLUCEmissionsToMarket( aRegionName, aPeriod );
     }  
 }
 
+/*!
+ * \brief Calls the carbon calculator to calculate the land use emissions of just
+ *        this leaf without adding them to the carbon market.
+ * \details This only touches this leaf and its carbon calc so that the emissions
+ *          of many leaves may be calculated concurrently.  The caller is responsible
+ *          for calling addLUCEmissionsToMarket when aStoreFullEmiss is false.
+ * \param aPeriod Current model period.
+ * \param aEndYear The year to calculate LUC emissions to.
+ * \param aStoreFullEmiss Flag to pass on to the carbon calc.
+ */
+void LandLeaf::calcLeafLUCEmissions( const int aPeriod, const int aEndYear,
+                                     const bool aStoreFullEmiss )
+{
+    // Calculate the amount of emissions attributed to land use change in the current period
+    mLastCalcCO2Value = mCarbonContentCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
+}
+
+/*!
+ * \brief Adds the most recently calculated LUC emissions to the carbon market.
+ * \param aRegionName Region.
+ * \param aPeriod Current model period.
+ */
+void LandLeaf::addLUCEmissionsToMarket( const string& aRegionName,
+                                        const int aPeriod ) const
+{
+    Marketplace* marketplace = scenario->getMarketplace();
+    marketplace->addToDemand( "CO2_LUC", aRegionName,
+                              mLastCalcCO2Value, aPeriod, false );
+}
+
 /*!
 * \brief Returns the land allocation of this leaf
 * \param aProductName Product name.
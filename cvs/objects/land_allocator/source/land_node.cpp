@@ -340,38 +340,60 @@ double LandNode::calcLandShares( const string& aRegionName,
                                  IDiscreteChoice* aChoiceFnAbove,
                                  const int aPeriod )
 {
+    // These calls need to be made to initiate recursion into lower nests even
+    // if the current node will have fixed shares.  The children do not calculate
+    // their own unnormalized share so that they may all be calculated at once.
+    for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
+        mChildren[ i ]->calcLandShares( aRegionName, 0, aPeriod );
+    }
 
-    vector<double> unnormalizedShares( mChildren.size() );
+    // Steps 1 through 3.
+    calcChildShares( aPeriod );
+
+    // Step 4. Calculate the unnormalized share for this node, but here using the discrete choice of the 
+    // containing or parant node.  This will be used to determine this nodes share within its 
+    // parent node.  Unless the parent will calculate it along with its other children.
+    if( !aChoiceFnAbove ) {
+        return 0;
+    }
+    double unnormalizedShareAbove = aChoiceFnAbove->calcUnnormalizedShare( mShareWeight[ aPeriod ], mProfitRate[ aPeriod ], aPeriod );
+    
+    return unnormalizedShareAbove; // the unnormalized share of this node.
+}
 
+/*!
+ * \brief Calculates the shares of the direct children of this node and the node
+ *        profit rate from them.
+ * \details This does not recurse, the shares and profit rates of any child nodes
+ *          must already have been calculated for aPeriod.  This allows the land
+ *          allocator to calculate the entire tree with a single loop over its
+ *          nodes.
+ * \param aPeriod Period.
+ */
+void LandNode::calcChildShares( const int aPeriod ) {
     // Step 1.  Calculate the unnormalized shares.
-    // These calls need to be made to initiate recursion into lower nests even
-    // if the current node will have fixed shares.
     // Note these are the log( unnormalized shares )
+    vector<double> shareWeights( mChildren.size() );
+    vector<double> profitRates( mChildren.size() );
+    vector<double> logShares( mChildren.size() );
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
-        unnormalizedShares[ i ] = mChildren[ i ]->calcLandShares( aRegionName,
-                                                                  mChoiceFn,
-                                                                  aPeriod );
+        shareWeights[ i ] = mChildren[ i ]->getShareWeight( aPeriod );
+        profitRates[ i ] = mChildren[ i ]->getProfitRate( aPeriod );
     }
+    mChoiceFn->calcUnnormalizedShares( shareWeights, profitRates, aPeriod, logShares );
 
     // Step 2 Normalize and set the share of each child
     // The log( unnormalized ) shares will be normalizd after this call and it will
     // do it making an attempt to avoid numerical instabilities given the profit rates
     // may be large values.  The value returned is a pair<unnormalizedSum, log(scale factor)>
     // again in order to try to make calculations in a numerically stable way.
-    pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( unnormalizedShares );
+    pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( logShares );
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
-        mChildren[ i ]->setShare( unnormalizedShares[ i ], aPeriod );
+        mChildren[ i ]->setShare( logShares[ i ], aPeriod );
     }
 
     // Step 3 Option (a) . compute node profit based on share denominator
     mProfitRate[ aPeriod ] = mChoiceFn->calcAverageValue( unnormalizedSum.first, unnormalizedSum.second, aPeriod );
-
-    // Step 4. Calculate the unnormalized share for this node, but here using the discrete choice of the 
-    // containing or parant node.  This will be used to determine this nodes share within its 
-    // parent node.
-    double unnormalizedShareAbove = aChoiceFnAbove->calcUnnormalizedShare( mShareWeight[ aPeriod ], mProfitRate[ aPeriod ], aPeriod );
-    
-    return unnormalizedShareAbove; // the unnormalized share of this node.
 }
 
 void LandNode::calculateShareWeights( const string& aRegionName, 
@@ -428,6 +450,16 @@ void LandNode::calculateNodeProfitRates( const string& aRegionName,
         mChildren[ i ]->calculateNodeProfitRates( aRegionName, aPeriod );
     }
 
+    calcNodeProfitRate( aPeriod );
+}
+
+/*!
+ * \brief Sets the base profit rate of this node from its direct children.
+ * \details This does not recurse, the profit rates of any child nodes must
+ *          already have been calculated for aPeriod.
+ * \param aPeriod Period.
+ */
+void LandNode::calcNodeProfitRate( const int aPeriod ) {
     // Calculate a reasonable "base" profit rate to use to set the scale for when
     // changes in absolute profit rates would be made relative.  We do this by
     // taking the higest profit rate from any of the direct child items.
@@ -485,15 +517,40 @@ void LandNode::calcLUCEmissions( const string& aRegionName,
                                  const int aPeriod, const int aEndYear,
                                  const bool aStoreFullEmiss )
 {
-    if( mCarbonCalc ) {
-        mCarbonCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
-    }
+    calcNodeLUCEmissions( aPeriod, aEndYear, aStoreFullEmiss );
     
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
         mChildren[ i ]->calcLUCEmissions( aRegionName, aPeriod, aEndYear, aStoreFullEmiss );
     }
 }
 
+/*!
+ * \brief Whether this node has a node carbon calc which drives the emissions
+ *        of its children.
+ * \return True if this node has a node carbon calc.
+ */
+bool LandNode::hasNodeCarbonCalc() const {
+    return mCarbonCalc != 0;
+}
+
+/*!
+ * \brief Calculates the LUC emissions of the node carbon calc, if any, without
+ *        recursing into the children.
+ * \details The node carbon calc sets the emissions into the carbon calcs of the
+ *          children so this must be called before the children calculate their
+ *          emissions.
+ * \param aPeriod The current model period.
+ * \param aEndYear The year to calculate LUC emissions to.
+ * \param aStoreFullEmiss Flag to pass on to the carbon calc.
+ */
+void LandNode::calcNodeLUCEmissions( const int aPeriod, const int aEndYear,
+                                     const bool aStoreFullEmiss )
+{
+    if( mCarbonCalc ) {
+        mCarbonCalc->calc( aPeriod, aEndYear, aStoreFullEmiss ? ICarbonCalc::eStoreResults : ICarbonCalc::eReturnTotal );
+    }
+}
+
 /*!
  * \brief Finds a child of this node that has the desired name and type.
  * \param aName The desired name.
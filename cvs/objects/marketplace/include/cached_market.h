@@ -62,10 +62,14 @@ class Value;
  *          calls to the Marketplace.
  *
  * \author Pralit Patel
+ *          Read-only queries (prices, supplies, demands, and market info) for
+ *          a period other than the one the market was located for are forwarded
+ *          to the Marketplace so that an object may keep its CachedMarket from
+ *          initCalc and still safely report results for other periods.
  * \warning It is up to the user to ensure the cached market matches the intended
- *          market, i.e. the good name, region name, and period have not changed.
- *          To ensure this does not happen a user could run in debug mode to check
- *          asserts.
+ *          market, i.e. the good name and region name have not changed and
+ *          modifications happen in the located period.  To ensure this does not
+ *          happen a user could run in debug mode to check asserts.
  */
 class CachedMarket
 {
@@ -103,10 +107,11 @@ private:
     
     //! The region name used when this market was located.  Used for debugging.
     const std::string mRegionName;
+#endif
     
-    //! The period used when this market was located.  Used for debugging.
+    //! The period used when this market was located.  Queries for any other
+    //! period are forwarded to the Marketplace.
     const int mPeriod;
-#endif
     //! The actual market which is cached.
     Market* mCachedMarket;
 };
@@ -197,6 +197,8 @@ public:
     void restore_prices_for_cost_calculation();
     
     MarketDependencyFinder* getDependencyFinder() const;
+    
+    static bool isDerivativeCalc();
 
     // The methods from here down are diagnostics
     std::vector<double> fullstate( int period ) const; //!< Return all supplies and demands in all markets in a single vector
@@ -55,7 +55,7 @@ extern Scenario* scenario;
  * \brief Constructor which takes the parameters used to locate the given market.
  * \param aGoodName The good name used to locate aLocatedMarket.  Stored for debugging.
  * \param aGoodName The region name used to locate aLocatedMarket.  Stored for debugging.
- * \param aGoodName The period used to locate aLocatedMarket.  Stored for debugging.
+ * \param aGoodName The period used to locate aLocatedMarket.
  * \param aLocatedMarket A pointer to the actual market which was located.  Note that this
  *                       parameter can be null which indicates the market was not found.
  */
@@ -65,8 +65,8 @@ CachedMarket::CachedMarket( const string& aGoodName, const string& aRegionName,
 #ifndef NDEBUG
 mGoodName( aGoodName ),
 mRegionName( aRegionName ),
-mPeriod( aPeriod ),
 #endif
+mPeriod( aPeriod ),
 mCachedMarket( aLocatedMarket )
 {
 }
@@ -242,10 +242,10 @@ double CachedMarket::getPrice( const string& aGoodName, const string& aRegionNam
      */
     assert( aRegionName == mRegionName );
     
-    /*!
-     * \invariant The given period matches the one that was used when locating this market.
-     */
-    assert( aPeriod == mPeriod );
+    // Queries for other periods can not use the cached market.
+    if( aPeriod != mPeriod ) {
+        return scenario->getMarketplace()->getPrice( aGoodName, aRegionName, aPeriod, aMustExist );
+    }
     
     if( mCachedMarket ) {
         return mCachedMarket->getPrice();
@@ -281,10 +281,10 @@ double CachedMarket::getSupply( const string& aGoodName, const string& aRegionNa
      */
     assert( aRegionName == mRegionName );
     
-    /*!
-     * \invariant The given period matches the one that was used when locating this market.
-     */
-    assert( aPeriod == mPeriod );
+    // Queries for other periods can not use the cached market.
+    if( aPeriod != mPeriod ) {
+        return scenario->getMarketplace()->getSupply( aGoodName, aRegionName, aPeriod );
+    }
     
     if ( mCachedMarket ) {
         return mCachedMarket->getSupply();
@@ -317,10 +317,10 @@ double CachedMarket::getDemand(  const string& aGoodName, const string& aRegionN
      */
     assert( aRegionName == mRegionName );
     
-    /*!
-     * \invariant The given period matches the one that was used when locating this market.
-     */
-    assert( aPeriod == mPeriod );
+    // Queries for other periods can not use the cached market.
+    if( aPeriod != mPeriod ) {
+        return scenario->getMarketplace()->getDemand( aGoodName, aRegionName, aPeriod );
+    }
     
     if ( mCachedMarket ) {
         return mCachedMarket->getDemand();
@@ -360,10 +360,10 @@ const IInfo* CachedMarket::getMarketInfo( const string& aGoodName, const string&
      */
     assert( aRegionName == mRegionName );
     
-    /*!
-     * \invariant The given period matches the one that was used when locating this market.
-     */
-    assert( aPeriod == mPeriod );
+    // Queries for other periods can not use the cached market.
+    if( aPeriod != mPeriod ) {
+        return static_cast<const Marketplace*>( scenario->getMarketplace() )->getMarketInfo( aGoodName, aRegionName, aPeriod, aMustExist );
+    }
 
     const IInfo* info = 0;
     if ( mCachedMarket ) {
@@ -412,10 +412,10 @@ IInfo* CachedMarket::getMarketInfo( const string& aGoodName, const string& aRegi
      */
     assert( aRegionName == mRegionName );
     
-    /*!
-     * \invariant The given period matches the one that was used when locating this market.
-     */
-    assert( aPeriod == mPeriod );
+    // Queries for other periods can not use the cached market.
+    if( aPeriod != mPeriod ) {
+        return scenario->getMarketplace()->getMarketInfo( aGoodName, aRegionName, aPeriod, aMustExist );
+    }
     
     IInfo* info = 0;
     if ( mCachedMarket ) {
@@ -897,6 +897,15 @@ MarketDependencyFinder* Marketplace::getDependencyFinder() const {
     return mDependencyFinder.get();
 }
 
+/*!
+ * \brief Whether the current call to world->calc() is part of a partial
+ *        derivative calculation.
+ * \return True if calculating a partial derivative.
+ */
+bool Marketplace::isDerivativeCalc() {
+    return mIsDerivativeCalc;
+}
+
 /*!
  * \brief Get the full state of the marketplace.
  * \param period The model period.
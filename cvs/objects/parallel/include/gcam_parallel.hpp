@@ -37,7 +37,9 @@
 
 /* standard headers */
 #include <list>
+#include <map>
 #include <set>
+#include <vector>
 
 /* graph analysis headers */
 #include "parallel/include/digraph.hpp"
@@ -48,6 +50,20 @@
 // Forward declare when possible
 class IActivity;
 class MarketDependencyFinder;
+class Timer;
+
+/*!
+ * \brief The measured calculation cost of a single activity.
+ */
+struct ActivityCost {
+    ActivityCost() : mTotalTime( 0.0 ), mNumCalls( 0 ) {}
+    
+    //! Total wall clock time in seconds spent in IActivity::calc.
+    double mTotalTime;
+    
+    //! The number of times the activity was calculated.
+    int mNumCalls;
+};
 
 /*!
  * \brief Class to package all of the information we need to carry around to use the flow graph
@@ -59,7 +75,8 @@ class GcamFlowGraph {
     friend class MarketDependencyFinder;
 private:
     //! Private constructor to only allow select classes to create flow graphs.
-    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ) {}
+    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ),
+        mProfileCallsRemaining( 0 ), mIsCostWeighted( false ) {}
     
     //! The TBB calculation flow graph.
     tbb::flow::graph mTBBFlowGraph;
@@ -75,6 +92,23 @@ private:
     //! not be calculated for sub-graphs.  Note when null it implies all activities
     //! will be calculated.
     const std::vector<IActivity*>* mCalcList;
+    
+    //! The calculation cost of each activity in the graph.  Entries are created
+    //! when the graph is built so that the grains can record their times without
+    //! modifying the structure of the map while running in parallel.
+    std::map<IActivity*, ActivityCost> mActivityCosts;
+    
+    //! The number of remaining model calculations for which activity costs should
+    //! be recorded.  Once this reaches zero the costs are available to rebuild the
+    //! grains.
+    int mProfileCallsRemaining;
+    
+    //! Whether the grains of this graph were collected using measured costs.
+    bool mIsCostWeighted;
+    
+    //! The grain graph this flow graph was built from, kept to be able to report
+    //! on the grain layout once costs have been measured.
+    digraph<IActivity*> mGrainGraph;
 };
 
 /*!
@@ -99,15 +133,25 @@ public:
     /* Graph analysis and parsing methods */
     void makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyFinder, FlowGraph& aGCAMFlowGraph );
     
-    void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph );
+    void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                                 const std::map<IActivity*, ActivityCost>* aActivityCosts = 0 );
     
     void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
-                                 const std::vector<FlowGraphNodeType>& aCalcItems );
+                                 const std::vector<FlowGraphNodeType>& aCalcItems ) const;
     
     void makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
                            GcamFlowGraph& aTBBGraph );
+    
+    void reportGrainCosts( const FlowGraph& aGrainGraph,
+                           const std::map<IActivity*, ActivityCost>& aActivityCosts ) const;
+    
+    int getNumProfileCalls() const;
   
 protected:
+    void parseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                            const std::map<IActivity*, ActivityCost>* aActivityCosts,
+                            Timer* aParseTimer, Timer* aGrainTimer ) const;
+    
     //! Helper class for sorting lists in topological order
     struct TopologicalComparator {
         TopologicalComparator(const FlowGraph& aGraph ) : mTopology( aGraph ) {}
@@ -134,7 +178,7 @@ protected:
      */
     struct TBBFlowGraphBody {
         TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes, const FlowGraph& aTopology,
-                          const GcamFlowGraph& aGraph );
+                          GcamFlowGraph& aGraph );
         
         void operator()( tbb::flow::continue_msg aMessage );
 
@@ -142,6 +186,9 @@ protected:
         //! to execute.
         std::list<FlowGraphNodeType> mNodes;
         
+        //! The cost entry for each activity in mNodes, in the same order.
+        std::vector<ActivityCost*> mCosts;
+        
         //! A reference to the TBB flow graph to which this node belongs.
         const GcamFlowGraph& mGraph;
     };
@@ -161,8 +208,16 @@ protected:
     //! Default grain size
     static const int DEFAULT_GRAIN_SIZE;
     
-    // right now, grain size is the only parameter in the heuristics.
-    // We may add more later.
+    /*!
+     * \brief The number of model calculations to profile before rebuilding
+     *        the grains weighted by measured activity costs.
+     * \details Zero disables profiling and the grains are only ever sized by
+     *          the number of activities they contain.
+     */
+    int mNumProfileCalls;
+    
+    // right now, grain size is the only parameter in the heuristics
+    // although the grains may be weighted by measured costs.
 };
 
   
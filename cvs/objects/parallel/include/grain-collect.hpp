@@ -37,6 +37,7 @@
 #include "parallel/include/clanid.hpp"
 #include "parallel/include/bitvector.hpp"
 #include <sstream>
+#include <vector>
 
 template<class T> T* unique_nodetitle(T* bestnode, size_t setsize)
 {
@@ -109,11 +110,39 @@ nodeid_t grain_title(const bitvector &nodeset, const digraph<nodeid_t> &topology
 }
 
 
+/* Compute the size of a set of nodes for the purposes of grain collection.
+ *
+ * Without weights this is just the number of nodes in the set.  With
+ * weights (indexed by topological index, like the bitvector itself)
+ * it is the sum of the weights of the nodes in the set.  Weights are
+ * expected to be normalized so that an average node has a weight of
+ * 1, which keeps the grain size target in the same units either way.
+ */
+inline double grain_weight(const bitvector &nodeset, const std::vector<double> *weights)
+{
+  if(!weights)
+    return nodeset.count();
+
+  double weight = 0.0;
+  bitvector_iterator nodeit(&nodeset);
+  while(nodeit.next())
+    weight += (*weights)[nodeit.bindex()];
+  return weight;
+}
+
+
+/* Collect the nodes of a clan into grains.
+ *
+ * If weights is non-null it gives the relative cost of each node by
+ * topological index, and grain sizes are measured by total cost
+ * rather than by the number of nodes (see grain_weight).
+ */
 template<class nodeid_t>
 void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
                    const typename digraph<clanid<nodeid_t> >::nodelist_c_iter_t &claniterator,
                    digraph <nodeid_t> &GrainGraph,
-                   unsigned grain_min)
+                   unsigned grain_min,
+                   const std::vector<double> *weights = 0)
 {
   // define the clanid type
   typedef clanid<nodeid_t> Clanid;
@@ -146,10 +175,10 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     {
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
-      unsigned nsub = subclan->nodes().count();
+      double nsub = grain_weight(subclan->nodes(), weights);
       // search large subclans for grains
       if(nsub >= grain_min)
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, weights);
       else
         node_group.setunion(subclan->nodes());
     }
@@ -160,8 +189,8 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     // exactly, since we don't know the distribution of the sizes of
     // the leftover clans.  We'll guess that they're pretty uniform
     // and build heuristics around that.
-    int nnode = node_group.count(); // cache the number of nodes in the group.  Be careful to update whenever we change the group membership!
-    int nbreakup = nnode / grain_min;
+    double nnode = grain_weight(node_group, weights); // cache the size of the group.  Be careful to update whenever we change the group membership!
+    int nbreakup = static_cast<int>(nnode / grain_min);
     if(nbreakup < 2 && nnode >= ind_split_min )
       // fudge the minimum grain size a little for extra parallelism.
       // It was probably just a guess anyhow.
@@ -169,19 +198,26 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
 
     if(nbreakup > 1) {
       // this will be the approximate size of the new grains we will make.
-      unsigned grain_size_thresh = nnode / nbreakup;
+      // Without weights this is truncated to a whole number of nodes as
+      // it always has been.
+      double grain_size_thresh = weights ? nnode / nbreakup : static_cast<unsigned>(nnode / nbreakup);
       node_group.clearall();       // nnode no lonber valid!
+      double group_size = 0.0;
       for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
-          subclan != claniterator->second.successors.end(); ++subclan)
-        if(subclan->nodes().count() < grain_min) { // skip the ones that were already processed above
+          subclan != claniterator->second.successors.end(); ++subclan) {
+        double nsub = grain_weight(subclan->nodes(), weights);
+        if(nsub < grain_min) { // skip the ones that were already processed above
           node_group.setunion(subclan->nodes());
-          if(node_group.count() >= grain_size_thresh) {
+          group_size += nsub;
+          if(group_size >= grain_size_thresh) {
             // have enough for a grain
             grain_name = grain_title(node_group, topology);
             GrainGraph.collapse_subgraph(topology.convert_to_set(node_group), grain_name);
             node_group.clearall();   // start the next grain
+            group_size = 0.0;
           }
         }
+      }
     }
     
     if(!node_group.empty()) {
@@ -213,7 +249,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
       if( (subclan->type == independent || subclan->type == pseudoindependent) &&
-          subclan->nodes().count() >= ind_split_min ) {
+          grain_weight(subclan->nodes(), weights) >= ind_split_min ) {
         // only recurse on independent clans that are guaranteed to
         // split (an independent could split with as few as
         // grain_min+1 clans, but it's not guaranteed and rarely
@@ -226,7 +262,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
           node_group.clearall();   // start the next grain
         }
         // then recurse on the subclan
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, weights);
       }
       else {
         // add this clan's nodes to the node group
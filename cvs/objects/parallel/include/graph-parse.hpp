@@ -64,7 +64,8 @@
 //! grains.  So, it doesn't make too much sense to break up small
 //! primitive clans, only to roll them back up again.
 const unsigned primitive_reduce_minsize_default = 10;
-unsigned primitive_reduce_minsize;
+// Set by each call to graph_parse, which may run concurrently on different graphs.
+thread_local unsigned primitive_reduce_minsize;
 
 template <class nodeid_t>
 bitvector make_bitset(const std::set<nodeid_t> &nodeset,
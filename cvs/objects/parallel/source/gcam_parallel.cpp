@@ -32,6 +32,7 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include <map>
+#include <algorithm>
 /* gcam headers */
 #include "parallel/include/gcam_parallel.hpp"
 #include "util/base/include/configuration.h"
@@ -56,15 +57,26 @@ const int GcamParallel::DEFAULT_GRAIN_SIZE = 30;
  *
  * \details Checks configuration for parallel-grain-size tag.  If so,
  *            uses it to set mGrain_size_tgt; if not, uses the default
- *            value. 
- * \remark Grain size is currently the only configurable parameter,
- *         but others may be added in the future.  Consider
- *         configuration parameter names starting with "parallel-" to
- *         be reserved for this purpose.
+ *            value.  Also checks for parallel-profile-calls which sets
+ *            how many model calculations are profiled before the grains
+ *            are rebuilt using the measured costs.
+ * \remark Consider configuration parameter names starting with
+ *         "parallel-" to be reserved for this purpose.
  */
 GcamParallel::GcamParallel()
 {
-    mGrainSizeTarget = Configuration::getInstance()->getInt( "parallel-grain-size", DEFAULT_GRAIN_SIZE );
+    const Configuration* conf = Configuration::getInstance();
+    mGrainSizeTarget = conf->getInt( "parallel-grain-size", DEFAULT_GRAIN_SIZE );
+    mNumProfileCalls = conf->getInt( "parallel-profile-calls", 0, false );
+}
+
+/*!
+ * \brief Get the number of model calculations to profile before the grains
+ *        should be rebuilt weighted by the measured activity costs.
+ * \return The number of calculations to profile, zero if disabled.
+ */
+int GcamParallel::getNumProfileCalls() const {
+    return mNumProfileCalls;
 }
   
 
@@ -158,14 +170,13 @@ void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyF
  * \param[in] aGCAMFlowGraph: The gcam flow graph generated by makeGCAMFlowGraph 
  * \param[out] aGrainGraph: The graph of computational grains.  On input it
  *                          should be empty. 
+ * \param[in] aActivityCosts: Measured activity costs used to weight the grain
+ *                            sizes, or null to size grains by the number of
+ *                            activities they contain.
  */
-void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph )
+void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                                           const map<IActivity*, ActivityCost>* aActivityCosts )
 {
-    // some intermediate types involving "clans".  These will hold the
-    // intermediate results of the parsing.
-    typedef clanid<FlowGraphNodeType> ClanidType;
-    typedef digraph<ClanidType> ClanTree;
-
     AutoOutputFile graphFile( "flow-graph", "gcam-flow-graph.dot" );
     write_as_dot( *graphFile, aGCAMFlowGraph );
     
@@ -174,41 +185,109 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
     ILogger &mainlog = ILogger::getLogger("main_log");
     mainlog.setLevel(ILogger::DEBUG);
 
-    parsetimer.start();
+    parseGrainCollect( aGCAMFlowGraph, aGrainGraph, aActivityCosts, &parsetimer, &graintimer );
+
+    parsetimer.print(mainlog, "Graph parse in graphParseGrainCollect:  ");
+    graintimer.print(mainlog, "Grain collect in graphParseGrainCollect:  ");
+}
+
+/*!
+ * \brief Parse the GCAM flow graph and collect IActivies into computational grains.
+ * \details Performs the work of graphParseGrainCollect without writing the flow
+ *          graph or logging so that it is safe to call concurrently on different
+ *          graphs.
+ * \param[in] aGCAMFlowGraph: The gcam flow graph generated by makeGCAMFlowGraph 
+ * \param[out] aGrainGraph: The graph of computational grains.  On input it
+ *                          should be empty. 
+ * \param[in] aActivityCosts: Measured activity costs used to weight the grain
+ *                            sizes, or null to size grains by the number of
+ *                            activities they contain.
+ * \param[in] aParseTimer: Timer to time the graph parse, may be null.
+ * \param[in] aGrainTimer: Timer to time the grain collection, may be null.
+ */
+void GcamParallel::parseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
+                                      const map<IActivity*, ActivityCost>* aActivityCosts,
+                                      Timer* aParseTimer, Timer* aGrainTimer ) const
+{
+    // some intermediate types involving "clans".  These will hold the
+    // intermediate results of the parsing.
+    typedef clanid<FlowGraphNodeType> ClanidType;
+    typedef digraph<ClanidType> ClanTree;
+
+    if( aParseTimer ) {
+        aParseTimer->start();
+    }
     FlowGraph gcamFGReduce = aGCAMFlowGraph.treduce(); // find transitive reduction of gcamfg
     gcamFGReduce.topological_sort();
     
     ClanTree parseTree; 
     graph_parse( gcamFGReduce, 0, parseTree, mGrainSizeTarget );
-    parsetimer.stop();
+    if( aParseTimer ) {
+        aParseTimer->stop();
+    }
     
     // Use the parse tree to roll up the node graph into a grain graph.  Start
     // with a copy of the node graph.
-    graintimer.start();
+    if( aGrainTimer ) {
+        aGrainTimer->start();
+    }
+    
+    // When costs were measured weight each activity, by topological index, relative
+    // to the average cost per calculation so the grain size target keeps its meaning.
+    // Activities which were never calculated are treated as average.
+    vector<double> weights;
+    if( aActivityCosts ) {
+        const size_t numNodes = gcamFGReduce.nodelist().size();
+        vector<double> costs( numNodes, -1.0 );
+        double totalCost = 0.0;
+        int numMeasured = 0;
+        for( FlowGraph::nodelist_c_iter_t nodeIt = gcamFGReduce.nodelist().begin();
+             nodeIt != gcamFGReduce.nodelist().end(); ++nodeIt )
+        {
+            map<IActivity*, ActivityCost>::const_iterator costIt = aActivityCosts->find( nodeIt->first );
+            if( costIt != aActivityCosts->end() && costIt->second.mNumCalls > 0 ) {
+                double cost = costIt->second.mTotalTime / costIt->second.mNumCalls;
+                costs[ gcamFGReduce.topological_index( nodeIt ) ] = cost;
+                totalCost += cost;
+                ++numMeasured;
+            }
+        }
+        if( numMeasured > 0 && totalCost > 0.0 ) {
+            const double meanCost = totalCost / numMeasured;
+            weights.resize( numNodes, 1.0 );
+            for( size_t i = 0; i < numNodes; ++i ) {
+                if( costs[ i ] >= 0.0 ) {
+                    weights[ i ] = costs[ i ] / meanCost;
+                }
+            }
+        }
+    }
     FlowGraph grainGraphTemp = gcamFGReduce;
-    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget );
+    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget,
+                   weights.empty() ? 0 : &weights );
     
     // set the output graph to the transitive reduction of what came out of the
     // grain collection algorithm.
     aGrainGraph = grainGraphTemp.treduce();
-    graintimer.stop();
-
-    parsetimer.print(mainlog, "Graph parse in graphParseGrainCollect:  ");
-    graintimer.print(mainlog, "Grain collect in graphParseGrainCollect:  ");
+    if( aGrainTimer ) {
+        aGrainTimer->stop();
+    }
 }
 
 /*!
  * \brief Parse the GCAM flow graph and collect IActivies into computational grains 
  *        for only a subset of the full graph.
  * \details This method determines the nodes which should remain in the graph according
- *          to aCalcItems then calls graphParseGrainCollect with that resulting graph.
+ *          to aCalcItems then parses and collects grains for that resulting graph.
+ *          Neither the flow graph nor any timing is written so that sub-graphs for
+ *          different markets may be built concurrently.
  * \param[in] aGCAMFlowGraph: The gcam flow graph generated by makeGCAMFlowGraph 
  * \param[out] aGrainGraph: The graph of computational grains.  On input it
  *                          should be empty. 
  * \param[in] aCalcItems: The list of items to use to subset aGCAMFlowGraph.
  */
 void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
-                                           const vector<FlowGraphNodeType>& aCalcItems )
+                                           const vector<FlowGraphNodeType>& aCalcItems ) const
 {
     FlowGraph::nodelist_t fullGraph = aGCAMFlowGraph.nodelist();
     FlowGraph::nodelist_t subGraph;
@@ -216,7 +295,7 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
         subGraph[ *it ] = fullGraph[ *it ];
     }
     FlowGraph subFlowGraph( subGraph, aGCAMFlowGraph.title() );
-    graphParseGrainCollect( subFlowGraph, aGrainGraph );
+    parseGrainCollect( subFlowGraph, aGrainGraph, 0, 0, 0 );
 }
 
 /*!
@@ -254,6 +333,7 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
     using tbb::flow::continue_msg;
     
     tbb::flow::graph& tbbFlowGraph = aTBBGraph.mTBBFlowGraph;
+    aTBBGraph.mGrainGraph = aGrainGraph;
     tbb::flow::broadcast_node<tbb::flow::continue_msg>& head = aTBBGraph.mHead;
     
     ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
@@ -317,22 +397,96 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
     // TBB flow graph is ready to go.
 }
 
+/*!
+ * \brief Report the critical path and achievable parallelism of a grain graph.
+ * \details Each grain is given the cost of calculating all of its activities
+ *          once, using the average measured cost per calculation.  The critical
+ *          path is the most expensive chain of dependent grains which bounds the
+ *          time a full model calculation can take regardless of the number of
+ *          threads.  The ratio of the total work to the critical path is the
+ *          parallelism the grain layout can achieve at most.
+ * \param aGrainGraph The graph of computational grains.
+ * \param aActivityCosts The measured costs of the activities.
+ */
+void GcamParallel::reportGrainCosts( const FlowGraph& aGrainGraph,
+                                     const map<IActivity*, ActivityCost>& aActivityCosts ) const
+{
+    FlowGraph sortedGrains = aGrainGraph;
+    sortedGrains.topological_sort();
+    
+    map<FlowGraphNodeType, double> grainCost;
+    double totalWork = 0.0;
+    double largestGrain = 0.0;
+    for( FlowGraph::nodelist_c_iter_t gnodeIt = sortedGrains.nodelist().begin();
+         gnodeIt != sortedGrains.nodelist().end(); ++gnodeIt )
+    {
+        set<FlowGraphNodeType> subGraphNodes;
+        getkeys( gnodeIt->second.subgraph->nodelist(), subGraphNodes );
+        double cost = 0.0;
+        for( set<FlowGraphNodeType>::const_iterator it = subGraphNodes.begin(); it != subGraphNodes.end(); ++it ) {
+            map<IActivity*, ActivityCost>::const_iterator costIt = aActivityCosts.find( *it );
+            if( costIt != aActivityCosts.end() && costIt->second.mNumCalls > 0 ) {
+                cost += costIt->second.mTotalTime / costIt->second.mNumCalls;
+            }
+        }
+        grainCost[ gnodeIt->first ] = cost;
+        totalWork += cost;
+        largestGrain = max( largestGrain, cost );
+    }
+    
+    // Find the longest path to the end of each grain visiting grains in topological
+    // order so that all of a grain's predecessors have been finalized first.
+    map<FlowGraphNodeType, double> pathCost( grainCost );
+    double criticalPath = 0.0;
+    const size_t numGrains = sortedGrains.nodelist().size();
+    for( size_t i = 0; i < numGrains; ++i ) {
+        FlowGraphNodeType grain = sortedGrains.topological_lookup( i );
+        const double grainEnd = pathCost[ grain ];
+        criticalPath = max( criticalPath, grainEnd );
+        const set<FlowGraphNodeType>& successors = sortedGrains.getnode( grain ).successors;
+        for( set<FlowGraphNodeType>::const_iterator succIt = successors.begin(); succIt != successors.end(); ++succIt ) {
+            pathCost[ *succIt ] = max( pathCost[ *succIt ], grainEnd + grainCost[ *succIt ] );
+        }
+    }
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Flow graph grains: " << numGrains << ", total work: " << totalWork
+            << "s, largest grain: " << largestGrain << "s, critical path: " << criticalPath
+            << "s, achievable parallelism: " << ( criticalPath > 0.0 ? totalWork / criticalPath : 0.0 )
+            << endl;
+}
+
 void GcamParallel::TBBFlowGraphBody::operator()( tbb::flow::continue_msg aMessage )
 {
+    // Each activity belongs to exactly one grain so the cost entries can be
+    // updated without any locking.
+    const bool shouldProfile = mGraph.mProfileCallsRemaining > 0;
+    vector<ActivityCost*>::const_iterator costIt = mCosts.begin();
     for( list<FlowGraphNodeType>::const_iterator nodeIt = mNodes.begin();
-         nodeIt != mNodes.end(); ++nodeIt )
+         nodeIt != mNodes.end(); ++nodeIt, ++costIt )
     {
         if( !mGraph.mCalcList ||
             find( mGraph.mCalcList->begin(), mGraph.mCalcList->end(), *nodeIt ) != mGraph.mCalcList->end() )
         {
-            (*nodeIt)->calc( mGraph.mPeriod );
+            if( shouldProfile ) {
+                Timer calcTimer;
+                calcTimer.start();
+                (*nodeIt)->calc( mGraph.mPeriod );
+                calcTimer.stop();
+                (*costIt)->mTotalTime += calcTimer.getTotalTimeDifference();
+                ++(*costIt)->mNumCalls;
+            }
+            else {
+                (*nodeIt)->calc( mGraph.mPeriod );
+            }
         }
     }
 }
 
 GcamParallel::TBBFlowGraphBody::TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes,
                                                   const FlowGraph& aTopology,
-                                                  const GcamFlowGraph& aGraph )
+                                                  GcamFlowGraph& aGraph )
 :mGraph( aGraph )
 {
     ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
@@ -347,6 +501,13 @@ GcamParallel::TBBFlowGraphBody::TBBFlowGraphBody( const std::set<FlowGraphNodeTy
     mNodes.insert( mNodes.end(), aNodes.begin(), aNodes.end() );
     mNodes.sort( TopologicalComparator( aTopology ) );
     
+    // Create the cost entries now as the graph must not be structurally modified
+    // once calculations are running.
+    mCosts.reserve( mNodes.size() );
+    for( list<FlowGraphNodeType>::const_iterator it = mNodes.begin(); it != mNodes.end(); ++it ) {
+        mCosts.push_back( &aGraph.mActivityCosts[ *it ] );
+    }
+    
     // log some output to allow us to analyze the parallel grain
     // structure (this allows us to see what is in the grains, but not
     // the relationships between grains)
@@ -0,0 +1,184 @@
+#ifndef _COLUMNAR_DB_WRITER_H_
+#define _COLUMNAR_DB_WRITER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file columnar_db_writer.h
+* \ingroup Objects
+* \brief ColumnarDBWriter and ColumnarDBSink class header file.
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include <boost/shared_ptr.hpp>
+#include <boost/core/noncopyable.hpp>
+#include <boost/iostreams/concepts.hpp>
+
+/*! 
+* \ingroup Objects
+* \brief Writes the XML generated by the XMLDBOutputter to a compact columnar
+*        file without the need for Java.
+* \details The XML is read incrementally as it is written and each element which
+*          contains a value is converted into a row of the table.  Each row
+*          contains:
+*            - path: The path to the element such as region[USA]/supplysector[refining]
+*              where the other attributes of a container are written in braces
+*              such as technology[oil refining]{year=2005}.
+*            - variable: The element name along with any attributes other than
+*              year, vintage or unit in braces.
+*            - unit: The unit attribute, if any.
+*            - year: The year (or vintage) attribute or -1 if not set.
+*            - value: The value, elements which are not numeric are skipped.
+*          Path, variable and unit are dictionary encoded as nearly all of them
+*          repeat many times.  The file starts with the eight characters GCAMCOL1
+*          followed by the format version and number of columns (uint32 each).
+*          Rows are written in groups, each being the number of rows (uint32)
+*          followed by all of the values for each column in the order above as
+*          uint32 string ids, int32 years and double values.  A group with zero
+*          rows indicates the end of the data which is followed by the dictionary:
+*          the number of strings (uint32) then each string as its length (uint32)
+*          and characters.  Finally the total number of rows is written (uint64).
+*/
+class ColumnarDBWriter : private boost::noncopyable {
+public:
+    explicit ColumnarDBWriter( const std::string& aFileName );
+    ~ColumnarDBWriter();
+    
+    bool isOpen() const;
+    
+    void write( const char* aData, const std::streamsize aLength );
+    
+    bool beginLocation( const std::string& aLocation );
+    
+    void endLocation();
+    
+    void close();
+
+private:
+    //! An element which has been opened but not yet closed.
+    struct OpenElement {
+        //! The element name.
+        std::string mName;
+        
+        //! The id of the path to this element for its children to use.
+        unsigned int mPathID;
+        
+        //! The id of the variable name to use if this element contains a value.
+        unsigned int mVariableID;
+        
+        //! The id of the unit attribute.
+        unsigned int mUnitID;
+        
+        //! The year or vintage attribute.
+        int mYear;
+        
+        //! Whether any child elements have been opened.
+        bool mHasChildren;
+    };
+    
+    //! The output file.
+    std::ofstream mFile;
+    
+    //! The stack of currently open elements.
+    std::vector<OpenElement> mOpenElements;
+    
+    //! The most recently opened element at each depth of the current path.
+    std::vector<OpenElement> mLastElements;
+    
+    //! The tag or text that is currently being read.
+    std::string mToken;
+    
+    //! The text which followed the most recent tag.
+    std::string mText;
+    
+    //! Whether mToken is a tag.
+    bool mInTag;
+    
+    //! The quote character if in the middle of an attribute value of a tag, 0 otherwise.
+    char mQuote;
+    
+    //! The dictionary of strings.
+    std::vector<std::string> mStrings;
+    
+    //! The id of each string in mStrings.
+    std::unordered_map<std::string, unsigned int> mStringIDs;
+    
+    //! The columns of the current group of rows.
+    std::vector<unsigned int> mPaths;
+    std::vector<unsigned int> mVariables;
+    std::vector<unsigned int> mUnits;
+    std::vector<int> mYears;
+    std::vector<double> mValues;
+    
+    //! The total number of rows written.
+    unsigned long long mNumRows;
+    
+    unsigned int getStringID( const std::string& aString );
+    
+    void processTag( const std::string& aTag );
+    
+    void addRow( const OpenElement& aElement, const std::string& aText );
+    
+    void writeRows();
+    
+    static std::string unescape( const std::string& aString );
+};
+
+/*!
+* \ingroup Objects
+* \brief A boost IO "sink" which transfers XML as it is written to a ColumnarDBWriter.
+* \details Boost copies sinks when they are pushed onto a stream so the writer is
+*          shared.
+*/
+class ColumnarDBSink : public boost::iostreams::sink {
+public:
+    explicit ColumnarDBSink( const boost::shared_ptr<ColumnarDBWriter>& aWriter ):mWriter( aWriter ) {}
+    
+    // boost::iostreams::sink methods
+    std::streamsize write( const char* aData, std::streamsize aLength ) {
+        mWriter->write( aData, aLength );
+        return aLength;
+    }
+private:
+    //! The writer to send data to.
+    boost::shared_ptr<ColumnarDBWriter> mWriter;
+};
+
+#endif // _COLUMNAR_DB_WRITER_H_
@@ -48,8 +48,11 @@
 #include <memory>
 #include <iosfwd>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <boost/shared_ptr.hpp>
 #include "util/base/include/default_visitor.h"
 
+class ColumnarDBWriter;
+
 #if( __HAVE_JAVA__ )
 #include <jni.h>
 #include <boost/iostreams/concepts.hpp>
@@ -70,6 +73,8 @@ public:
 
     static bool checkJavaWorking();
 
+    static bool isColumnarBackend();
+
     void finish() const;
     void finalizeAndClose();
 
@@ -262,6 +267,10 @@ private:
     //! database.
     std::stack<std::iostream*> mBufferStack;
 
+    //! The writer of the native columnar output file, only set when the
+    //! xmldb-backend is columnar in which case Java is not used.
+    boost::shared_ptr<ColumnarDBWriter> mColumnarWriter;
+
 #if( __HAVE_JAVA__ )
     /*!
      * \brief Contains all objects necessary to interact with Java.
@@ -295,6 +304,8 @@ private:
 #endif
     static const std::string createContainerName( const std::string& aScenarioName );
 
+    static std::string getColumnarFileName();
+
     void writeItemToBuffer( const double aValue,
         const std::string& aName,
         std::ostream& out,
@@ -64,6 +64,22 @@ using namespace std;
 */
 BatchCSVOutputter::BatchCSVOutputter():
 mFile( "batchCSVOutputFile", "batch-csv-out.csv" ),
+mOut( &*mFile ),
+mIsFirstScenario(true)
+{
+}
+
+/*!
+ * \brief Constructor which captures the results in the given stream rather than
+ *        writing the batch CSV file.
+ * \details This is used to collect the results of a scenario run in another
+ *          process so they can be passed to writeCapturedOutput of the
+ *          outputter which owns the file.
+ * \param aOut The stream to write results to.
+ */
+BatchCSVOutputter::BatchCSVOutputter( ostream& aOut ):
+mFile( "batchCSVOutputFile", "batch-csv-out.csv", false ),
+mOut( &aOut ),
 mIsFirstScenario(true)
 {
 }
@@ -81,18 +97,18 @@ void BatchCSVOutputter::startVisitScenario( const Scenario* aScenario, const int
     // we can not put this in the constructor because we will not have a model time
     // a that point
     if( mIsFirstScenario ) {
-        mFile << "Scenario" << ',';
+        *mOut << "Scenario" << ',';
         const Modeltime* modeltime = aScenario->getModeltime();
 
         for( int period = 0; period < modeltime->getmaxper(); ++period ) {
             // TODO: hard coding CO2
             const int year = modeltime->getper_to_yr( period );
-            mFile << year << ' '<< "CO2 Price" << ',';
+            *mOut << year << ' '<< "CO2 Price" << ',';
         }
         for( int period = 0; period < modeltime->getmaxper(); ++period ) {
             // TODO: hard coding CO2
             const int year = modeltime->getper_to_yr( period );
-            mFile << year << ' '<< "CO2 Emissions" << ',';
+            *mOut << year << ' '<< "CO2 Emissions" << ',';
         }
 
         int outputInterval = Configuration::getInstance()->getInt( "climateOutputInterval",
@@ -105,25 +121,25 @@ void BatchCSVOutputter::startVisitScenario( const Scenario* aScenario, const int
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Concentration" << ',';
+            *mOut << year << ' '<< "CO2 Concentration" << ',';
         }
         for( int year = scenario->getModeltime()->getStartYear();
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Radiative Forcing" << ',';
+            *mOut << year << ' '<< "CO2 Radiative Forcing" << ',';
         }
         for( int year = scenario->getModeltime()->getStartYear();
              year <= endingYear; year += outputInterval )
         {
             // TODO: hard coding CO2
-            mFile << year << ' '<< "CO2 Temperature Change" << ',';
+            *mOut << year << ' '<< "CO2 Temperature Change" << ',';
         }
-        mFile << "Solved" << endl;
+        *mOut << "Solved" << endl;
     }
     mIsFirstScenario = false;
 
-    mFile << aScenario->getName() << ',';
+    *mOut << aScenario->getName() << ',';
     // TODO: perhaps write some date/time or something
 }
 
@@ -132,10 +148,10 @@ void BatchCSVOutputter::startVisitMarket( const Market* aMarket, const int aPeri
         /*!
          * \warninng This is assuming the periods will be visited in appropriate order.
          */
-        mFile << "" << aMarket->getPrice() << ',';
+        *mOut << "" << aMarket->getPrice() << ',';
         
         // would this be wrong if it didn't solve?
-        //mFile << "" << aMarket->getDemand() << ',';
+        //*mOut << "" << aMarket->getDemand() << ',';
     }
 }
 
@@ -143,7 +159,7 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
     const Modeltime* modeltime = scenario->getModeltime();
     for( int period = 0; period < modeltime->getmaxper(); ++period ) {
         const int year = modeltime->getper_to_yr( period );
-        mFile << "" << aClimateModel->getEmissions( "CO2", year ) << ',';
+        *mOut << "" << aClimateModel->getEmissions( "CO2", year ) << ',';
     }
     
     int outputInterval
@@ -157,17 +173,17 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getConcentration( "CO2", year ) << ',';
+        *mOut << "" << aClimateModel->getConcentration( "CO2", year ) << ',';
     }
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getForcing( "CO2", year) << ',';
+        *mOut << "" << aClimateModel->getForcing( "CO2", year) << ',';
     }
     for( int year = modeltime->getStartYear();
          year <= endingYear; year += outputInterval )
     {
-        mFile << "" << aClimateModel->getTemperature( year ) << ',';
+        *mOut << "" << aClimateModel->getTemperature( year ) << ',';
     }
 }
 
@@ -176,5 +192,22 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
  * \param aDidSolve Whether the current scenario solved.
  */
 void BatchCSVOutputter::writeDidScenarioSolve( bool aDidSolve ) {
-    mFile << aDidSolve << endl;
+    *mOut << aDidSolve << endl;
+}
+
+/*!
+ * \brief Writes the results of a scenario captured by another BatchCSVOutputter.
+ * \details The captured output begins with a header line which is dropped if
+ *          the header has already been written.
+ * \param aOutput The captured output.
+ */
+void BatchCSVOutputter::writeCapturedOutput( const string& aOutput ) {
+    const size_t headerEnd = aOutput.find( '\n' );
+    if( mIsFirstScenario || headerEnd == string::npos ) {
+        *mOut << aOutput;
+    }
+    else {
+        *mOut << aOutput.substr( headerEnd + 1 );
+    }
+    mIsFirstScenario = false;
 }
@@ -0,0 +1,390 @@
+/*
+ * LEGAL NOTICE
+ * This computer software was prepared by Battelle Memorial Institute,
+ * hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+ * with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+ * CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+ * LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+ * sentence must appear on any copies of this computer software.
+ * 
+ * EXPORT CONTROL
+ * User agrees that the Software will not be shipped, transferred or
+ * exported into any country or used in any manner prohibited by the
+ * United States Export Administration Act or any other applicable
+ * export laws, restrictions or regulations (collectively the "Export Laws").
+ * Export of the Software may require some form of license or other
+ * authority from the U.S. Government, and failure to obtain such
+ * export control license may result in criminal liability under
+ * U.S. laws. In addition, if the Software is identified as export controlled
+ * items under the Export Laws, User represents and warrants that User
+ * is not a citizen, or otherwise located within, an embargoed nation
+ * (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+ *     and that User is not otherwise prohibited
+ * under the Export Laws from receiving the Software.
+ * 
+ * Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+ * Distributed as open-source under the terms of the Educational Community 
+ * License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+ * 
+ * For further details, see: http://www.globalchange.umd.edu/models/gcam/
+ *
+ */
+
+
+/*! 
+* \file columnar_db_writer.cpp
+* \ingroup Objects
+* \brief ColumnarDBWriter class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cstdlib>
+#include <cstring>
+
+#include "reporting/include/columnar_db_writer.h"
+
+using namespace std;
+
+//! The identifier at the start of every columnar file.
+const char COLUMNAR_FILE_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'C', 'O', 'L', '1' };
+
+//! The current version of the columnar file format.
+const unsigned int COLUMNAR_FILE_VERSION = 1;
+
+//! The number of columns in each row.
+const unsigned int NUM_COLUMNS = 5;
+
+//! The number of rows to collect before writing a group of them.
+const size_t ROW_GROUP_SIZE = 65536;
+
+/*!
+ * \brief Constructor which opens the file and writes the header.
+ * \param aFileName The name of the file to write.
+ */
+ColumnarDBWriter::ColumnarDBWriter( const string& aFileName ):
+mFile( aFileName.c_str(), ios_base::out | ios_base::trunc | ios_base::binary ),
+mInTag( false ),
+mQuote( 0 ),
+mNumRows( 0 )
+{
+    if( mFile.is_open() ) {
+        mFile.write( COLUMNAR_FILE_MAGIC, sizeof( COLUMNAR_FILE_MAGIC ) );
+        mFile.write( reinterpret_cast<const char*>( &COLUMNAR_FILE_VERSION ), sizeof( unsigned int ) );
+        mFile.write( reinterpret_cast<const char*>( &NUM_COLUMNS ), sizeof( unsigned int ) );
+    }
+    mPaths.reserve( ROW_GROUP_SIZE );
+    mVariables.reserve( ROW_GROUP_SIZE );
+    mUnits.reserve( ROW_GROUP_SIZE );
+    mYears.reserve( ROW_GROUP_SIZE );
+    mValues.reserve( ROW_GROUP_SIZE );
+}
+
+//! Destructor which ensures the file is completed.
+ColumnarDBWriter::~ColumnarDBWriter() {
+    close();
+}
+
+/*!
+ * \brief Whether the file was successfully opened and has not been closed.
+ * \return If the file is open.
+ */
+bool ColumnarDBWriter::isOpen() const {
+    return mFile.is_open();
+}
+
+/*!
+ * \brief Read the next chunk of XML.
+ * \details The XML may be split at any point between calls.
+ * \param aData The XML.
+ * \param aLength The number of characters in aData.
+ */
+void ColumnarDBWriter::write( const char* aData, const streamsize aLength ) {
+    for( streamsize i = 0; i < aLength; ++i ) {
+        const char curr = aData[ i ];
+        if( mInTag ) {
+            if( mQuote ) {
+                if( curr == mQuote ) {
+                    mQuote = 0;
+                }
+            }
+            else if( curr == '"' || curr == '\'' ) {
+                mQuote = curr;
+            }
+            else if( curr == '>' ) {
+                processTag( mToken );
+                mToken.clear();
+                mInTag = false;
+                continue;
+            }
+            mToken += curr;
+        }
+        else if( curr == '<' ) {
+            mText.swap( mToken );
+            mToken.clear();
+            mInTag = true;
+        }
+        else {
+            mToken += curr;
+        }
+    }
+}
+
+/*!
+ * \brief Place the XML written until endLocation is called at a location in the
+ *        data which has already been written.
+ * \details The location is an XPath from the root element in which each step
+ *          may only select the last element of that name, such as
+ *          /scenario/world/region[last()].  The XML which has been written so far
+ *          must be complete.
+ * \param aLocation XPath of the element to add the XML to.
+ * \return Whether the location could be found.
+ */
+bool ColumnarDBWriter::beginLocation( const string& aLocation ) {
+    if( !mOpenElements.empty() ) {
+        return false;
+    }
+    vector<OpenElement> location;
+    size_t stepStart = aLocation.find_first_not_of( '/' );
+    while( stepStart != string::npos ) {
+        const size_t stepEnd = aLocation.find( '/', stepStart );
+        const string step = aLocation.substr( stepStart, stepEnd == string::npos ? string::npos : stepEnd - stepStart );
+        const size_t predicateStart = step.find( '[' );
+        if( predicateStart != string::npos && step.compare( predicateStart, string::npos, "[last()]" ) != 0 ) {
+            return false;
+        }
+        const size_t depth = location.size();
+        if( depth >= mLastElements.size() || mLastElements[ depth ].mName != step.substr( 0, predicateStart ) ) {
+            return false;
+        }
+        location.push_back( mLastElements[ depth ] );
+        // The location only contains the new XML and so never has a value.
+        location.back().mHasChildren = true;
+        stepStart = stepEnd == string::npos ? stepEnd : aLocation.find_first_not_of( '/', stepEnd );
+    }
+    mOpenElements.swap( location );
+    return true;
+}
+
+/*!
+ * \brief Stop placing XML at the location set by beginLocation.
+ */
+void ColumnarDBWriter::endLocation() {
+    mOpenElements.clear();
+}
+
+/*!
+ * \brief Write any remaining rows and the dictionary then close the file.
+ * \details Nothing more can be written once closed.
+ */
+void ColumnarDBWriter::close() {
+    if( !mFile.is_open() ) {
+        return;
+    }
+    writeRows();
+    
+    const unsigned int endOfRows = 0;
+    mFile.write( reinterpret_cast<const char*>( &endOfRows ), sizeof( unsigned int ) );
+    const unsigned int numStrings = static_cast<unsigned int>( mStrings.size() );
+    mFile.write( reinterpret_cast<const char*>( &numStrings ), sizeof( unsigned int ) );
+    for( const auto& currString : mStrings ) {
+        const unsigned int length = static_cast<unsigned int>( currString.size() );
+        mFile.write( reinterpret_cast<const char*>( &length ), sizeof( unsigned int ) );
+        mFile.write( currString.data(), length );
+    }
+    mFile.write( reinterpret_cast<const char*>( &mNumRows ), sizeof( unsigned long long ) );
+    mFile.close();
+    
+    mStrings.clear();
+    mStringIDs.clear();
+}
+
+/*!
+ * \brief Get the id of the given string in the dictionary, adding it if necessary.
+ * \param aString The string to look up.
+ * \return The id of aString.
+ */
+unsigned int ColumnarDBWriter::getStringID( const string& aString ) {
+    auto found = mStringIDs.find( aString );
+    if( found != mStringIDs.end() ) {
+        return (*found).second;
+    }
+    const unsigned int id = static_cast<unsigned int>( mStrings.size() );
+    mStrings.push_back( aString );
+    mStringIDs[ aString ] = id;
+    return id;
+}
+
+/*!
+ * \brief Process a complete tag, the text between the angle brackets.
+ * \param aTag The contents of the tag.
+ */
+void ColumnarDBWriter::processTag( const string& aTag ) {
+    // Skip the XML declaration and any comments.
+    if( aTag.empty() || aTag[ 0 ] == '?' || aTag[ 0 ] == '!' ) {
+        return;
+    }
+    
+    if( aTag[ 0 ] == '/' ) {
+        // Closing an element that has no child elements means the text that was
+        // just read is its value.
+        if( !mOpenElements.empty() ) {
+            if( !mOpenElements.back().mHasChildren ) {
+                addRow( mOpenElements.back(), mText );
+            }
+            mOpenElements.pop_back();
+        }
+        return;
+    }
+    
+    const bool isEmptyElement = aTag[ aTag.size() - 1 ] == '/';
+    const size_t tagEnd = isEmptyElement ? aTag.size() - 1 : aTag.size();
+    size_t pos = aTag.find_first_of( " \t\r\n" );
+    pos = pos == string::npos ? tagEnd : min( pos, tagEnd );
+    
+    OpenElement element;
+    element.mName = aTag.substr( 0, pos );
+    element.mYear = -1;
+    element.mHasChildren = false;
+    string nameAttr;
+    string unitAttr;
+    string pathAttrs;
+    string variableAttrs;
+    while( true ) {
+        const size_t keyStart = aTag.find_first_not_of( " \t\r\n", pos );
+        if( keyStart == string::npos || keyStart >= tagEnd ) {
+            break;
+        }
+        const size_t equals = aTag.find( '=', keyStart );
+        const size_t valueStart = equals == string::npos ? string::npos : aTag.find_first_of( "\"'", equals );
+        const size_t valueEnd = valueStart == string::npos ? string::npos : aTag.find( aTag[ valueStart ], valueStart + 1 );
+        if( valueEnd == string::npos ) {
+            break;
+        }
+        const string key = aTag.substr( keyStart, aTag.find_last_not_of( " \t\r\n", equals - 1 ) + 1 - keyStart );
+        const string value = unescape( aTag.substr( valueStart + 1, valueEnd - valueStart - 1 ) );
+        pos = valueEnd + 1;
+        
+        if( key == "name" ) {
+            nameAttr = value;
+            continue;
+        }
+        pathAttrs += ( pathAttrs.empty() ? "{" : "," ) + key + "=" + value;
+        if( key == "year" || key == "vintage" ) {
+            element.mYear = atoi( value.c_str() );
+        }
+        else if( key == "unit" ) {
+            unitAttr = value;
+        }
+        else {
+            variableAttrs += ( variableAttrs.empty() ? "{" : "," ) + key + "=" + value;
+        }
+    }
+    if( !pathAttrs.empty() ) {
+        pathAttrs += "}";
+    }
+    if( !variableAttrs.empty() ) {
+        variableAttrs += "}";
+    }
+    
+    // The root element is not included in the path since there is only one.
+    if( mOpenElements.empty() ) {
+        element.mPathID = getStringID( "" );
+    }
+    else {
+        OpenElement& parent = mOpenElements.back();
+        parent.mHasChildren = true;
+        const string& parentPath = mStrings[ parent.mPathID ];
+        element.mPathID = getStringID( ( parentPath.empty() ? "" : parentPath + "/" ) + element.mName
+                                       + ( nameAttr.empty() ? "" : "[" + nameAttr + "]" ) + pathAttrs );
+    }
+    element.mVariableID = getStringID( element.mName + ( nameAttr.empty() ? "" : "[" + nameAttr + "]" ) + variableAttrs );
+    element.mUnitID = getStringID( unitAttr );
+    mText.clear();
+    mLastElements.resize( mOpenElements.size() );
+    mLastElements.push_back( element );
+    if( !isEmptyElement ) {
+        mOpenElements.push_back( element );
+    }
+}
+
+/*!
+ * \brief Add a row for an element which contains a value.
+ * \param aElement The element which is being closed.
+ * \param aText The text the element contained.
+ */
+void ColumnarDBWriter::addRow( const OpenElement& aElement, const string& aText ) {
+    const string value = unescape( aText );
+    const char* start = value.c_str();
+    char* end;
+    const double numericValue = strtod( start, &end );
+    if( end == start || value.find_first_not_of( " \t\r\n", end - start ) != string::npos ) {
+        // Not a number, only numeric values are kept.
+        return;
+    }
+    
+    // The path is that of the parent since aElement is the value.
+    mPaths.push_back( mOpenElements.size() > 1 ? mOpenElements[ mOpenElements.size() - 2 ].mPathID : getStringID( "" ) );
+    mVariables.push_back( aElement.mVariableID );
+    mUnits.push_back( aElement.mUnitID );
+    mYears.push_back( aElement.mYear );
+    mValues.push_back( numericValue );
+    if( mPaths.size() >= ROW_GROUP_SIZE ) {
+        writeRows();
+    }
+}
+
+/*!
+ * \brief Write the current group of rows to the file by column.
+ */
+void ColumnarDBWriter::writeRows() {
+    const unsigned int numRows = static_cast<unsigned int>( mPaths.size() );
+    if( numRows == 0 || !mFile.is_open() ) {
+        return;
+    }
+    mFile.write( reinterpret_cast<const char*>( &numRows ), sizeof( unsigned int ) );
+    mFile.write( reinterpret_cast<const char*>( mPaths.data() ), sizeof( unsigned int ) * numRows );
+    mFile.write( reinterpret_cast<const char*>( mVariables.data() ), sizeof( unsigned int ) * numRows );
+    mFile.write( reinterpret_cast<const char*>( mUnits.data() ), sizeof( unsigned int ) * numRows );
+    mFile.write( reinterpret_cast<const char*>( mYears.data() ), sizeof( int ) * numRows );
+    mFile.write( reinterpret_cast<const char*>( mValues.data() ), sizeof( double ) * numRows );
+    mNumRows += numRows;
+    
+    mPaths.clear();
+    mVariables.clear();
+    mUnits.clear();
+    mYears.clear();
+    mValues.clear();
+}
+
+/*!
+ * \brief Replace the predefined XML entities with the characters they represent.
+ * \param aString A string read from XML.
+ * \return The unescaped string.
+ */
+string ColumnarDBWriter::unescape( const string& aString ) {
+    if( aString.find( '&' ) == string::npos ) {
+        return aString;
+    }
+    static const char* ENTITIES[][ 2 ] = { { "&amp;", "&" }, { "&lt;", "<" }, { "&gt;", ">" },
+                                           { "&quot;", "\"" }, { "&apos;", "'" } };
+    string ret;
+    ret.reserve( aString.size() );
+    for( size_t i = 0; i < aString.size(); ++i ) {
+        bool replaced = false;
+        if( aString[ i ] == '&' ) {
+            for( auto entity : ENTITIES ) {
+                const size_t length = strlen( entity[ 0 ] );
+                if( aString.compare( i, length, entity[ 0 ] ) == 0 ) {
+                    ret += entity[ 1 ];
+                    i += length - 1;
+                    replaced = true;
+                    break;
+                }
+            }
+        }
+        if( !replaced ) {
+            ret += aString[ i ];
+        }
+    }
+    return ret;
+}
@@ -122,9 +122,7 @@
 #include <boost/iostreams/device/file.hpp>
 #endif
 
-#if( !__HAVE_JAVA__ )
 #include <boost/iostreams/device/null.hpp>
-#endif
 
 #include <ctime>
 
@@ -134,6 +132,7 @@
 #include <boost/math/tr1.hpp>
 
 #include "reporting/include/xml_db_outputter.h"
+#include "reporting/include/columnar_db_writer.h"
 
 extern Scenario* scenario; // for modeltime
 
@@ -193,13 +192,29 @@ mGDP( 0 )
     mBuffer.push( teeDebugFilter );
 #endif
 
+    if( isColumnarBackend() ) {
+        // Write the data natively to a columnar file.
+        const string columnarFileName = getColumnarFileName();
+        mColumnarWriter.reset( new ColumnarDBWriter( columnarFileName ) );
+        if( mColumnarWriter->isOpen() ) {
+            mBuffer.push( ColumnarDBSink( mColumnarWriter ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::SEVERE );
+            mainLog << "Could not open columnar output file " << columnarFileName << " for write." << endl;
+            mBuffer.push( null_sink() );
+        }
+    }
+    else {
 #if( __HAVE_JAVA__ )
-    // Set Java as the sink of data for mBuffer.
-    SendToJavaIOSink sendToJavaSink( mJNIContainer.get() );
-    mBuffer.push( sendToJavaSink );
+        // Set Java as the sink of data for mBuffer.
+        SendToJavaIOSink sendToJavaSink( mJNIContainer.get() );
+        mBuffer.push( sendToJavaSink );
 #else
-    mBuffer.push( null_sink() );
+        mBuffer.push( null_sink() );
 #endif
+    }
 }
 
 /*!
@@ -222,6 +237,10 @@ XMLDBOutputter::~XMLDBOutputter(){
  * \return True if it appears writing to the datbase would have been successful.
  */
 bool XMLDBOutputter::checkJavaWorking() {
+    // Java is not needed to write the columnar output.
+    if( isColumnarBackend() ) {
+        return true;
+    }
 #if( __HAVE_JAVA__ )
     auto_ptr<JNIContainer> testContainer = createContainer( true );
     // if we get back a null container then some error occured
@@ -243,6 +262,11 @@ void XMLDBOutputter::finish() const {
     // Close mBuffer so that no more data can be written.
     close( mBuffer, ios_base::out );
 
+    // The columnar file is left open until finalizeAndClose in case more data
+    // gets appended.
+    if( mColumnarWriter.get() ) {
+        return;
+    }
 #if( __HAVE_JAVA__ )
     if( !mJNIContainer.get() ) {
         // Failed to start Java, just return as an appropriate error message would
@@ -272,6 +296,10 @@ void XMLDBOutputter::finish() const {
  *          It may potentially run queries if configured then close the database.
  */
 void XMLDBOutputter::finalizeAndClose() {
+    if( mColumnarWriter.get() ) {
+        mColumnarWriter->close();
+        return;
+    }
 #if( __HAVE_JAVA__ )
     // Call finalizeAndClose on the XMLDBDriver if it was successfully opened in the first place.
     if( mJNIContainer.get() ) {
@@ -307,9 +335,9 @@ auto_ptr<XMLDBOutputter::JNIContainer> XMLDBOutputter::createContainer( const bo
     // Create a Java instance.
     auto_ptr<JNIContainer> jniContainer( new JNIContainer );
 
-    // Ensure the user wants this output
+    // Ensure the user wants this output and that it should be written via Java
     const Configuration* conf = Configuration::getInstance();
-    if( !conf->shouldWriteFile( "xmldb-location" ) ) {
+    if( !conf->shouldWriteFile( "xmldb-location" ) || isColumnarBackend() ) {
         jniContainer.reset( 0 );
         return jniContainer;
     }
@@ -423,6 +451,32 @@ const string XMLDBOutputter::createContainerName( const string& aScenarioName ){
     return aScenarioName + util::toString( runID );
 }
 
+/*!
+ * \brief Whether to write output natively to a columnar file rather than to the
+ *        XML database via Java.
+ * \details This is selected by setting the xmldb-backend string to columnar.
+ * \return True if the columnar backend should be used.
+ * \see ColumnarDBWriter
+ */
+bool XMLDBOutputter::isColumnarBackend() {
+    return Configuration::getInstance()->getString( "xmldb-backend", "basex", false ) == "columnar";
+}
+
+/*!
+ * \brief Get the name of the columnar output file.
+ * \details The name is based on the xmldb-location along with the unique
+ *          container name for the scenario.
+ * \return The columnar file name.
+ */
+string XMLDBOutputter::getColumnarFileName() {
+    const Configuration* conf = Configuration::getInstance();
+    string fileName = conf->getFile( "xmldb-location", "database_basexdb" );
+    if( conf->shouldAppendScnToFile( "xmldb-location") ) {
+        fileName.append( scenario->getName() );
+    }
+    return fileName + "." + createContainerName( scenario->getName() ) + ".gcol";
+}
+
 /*! \brief Append data at a given location to an already written database container.
 * \details
 * \param aData Data to append to the container.
@@ -445,6 +499,20 @@ bool XMLDBOutputter::appendData( const string& aData, const string& aLocation )
         return false;
     }
 
+    // The rows of the appended data must be placed under aLocation in the
+    // columnar file which only supports selecting the last element at each step.
+    if( mColumnarWriter.get() ) {
+        if( !mColumnarWriter->beginLocation( aLocation ) ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::ERROR );
+            mainLog << "Cannot append data to the columnar output at location " << aLocation << "." << endl;
+            return false;
+        }
+        mColumnarWriter->write( aData.data(), aData.size() );
+        mColumnarWriter->endLocation();
+        return mColumnarWriter->isOpen();
+    }
+
 #if( __HAVE_JAVA__ )
     // Check if creating the container failed.
     if( !mJNIContainer.get() ){
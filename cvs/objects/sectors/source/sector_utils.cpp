@@ -233,23 +233,23 @@ pair<double, double> SectorUtils::normalizeLogShares( vector<double>& alogShares
     // in theory we could check for lfac == +Inf here, but in light of how the log
     // shares are calculated, it would seem like that can't happen.
 
-    // rescale and get normalization sum
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] -= lfac;
-        sum += exp( alogShares[ i ] );
+    // rescale, unlog and get normalization sum.  The unlogged values are kept so
+    // that only one exp is needed per share.
+    const size_t numShares = alogShares.size();
+    for( size_t i = 0; i < numShares; ++i ) {
+        alogShares[ i ] = exp( alogShares[ i ] - lfac );
+        sum += alogShares[ i ];
     }
     double unnormAdjustedSum = sum;
-    double norm = log( sum );
-    sum = 0.0;                               // double check the normalization
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] = exp( alogShares[ i ] - norm );   // divide by norm constant and unlog
-        sum += alogShares[ i ];                      // accumulate sum of normalized shares 
-                                                     //   (should be 1.0 when we're done.)
+    const double invSum = 1.0 / sum;
+    for( size_t i = 0; i < numShares; ++i ) {
+        alogShares[ i ] *= invSum;                   // divide by norm constant
     }
     
     // In actuality, this rescaling scheme should eliminate the problem of
     // failed normalizations, but we'll allow for the possibility anyhow.
-    assert( sum < numeric_limits<double>::min() || util::isEqual( sum, 1.0 ) );
+    // The sum of normalized shares should be 1.0.
+    assert( util::isEqual( accumulate( alogShares.begin(), alogShares.end(), 0.0 ), 1.0 ) );
 
     return make_pair( unnormAdjustedSum, lfac );
 }
@@ -83,7 +83,8 @@ public:
   LogBroyden(Marketplace *mktplc, World *world, CalcCounter *ccounter, int itmax=250,
              double ftol=1.0e-4) :
       SolverComponent(mktplc,world,ccounter), mMaxIter( itmax ), mFTOL( ftol ),
-      mLogPricep( true ) {}
+      mLogPricep( true ), mColorJacobian( false ), mSparseSolve( false ),
+      mLinearTol( 1.0e-6 ), mMaxInverseUpdates( 0 ) {}
   virtual ~LogBroyden() {}
 
   // SolverComponent methods
@@ -125,6 +126,24 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price
 
+  //! flag indicating whether finite difference Jacobians should evaluate
+  //! groups of structurally independent markets together
+  bool mColorJacobian;
+
+  //! flag indicating whether the Jacobian should be stored in sparse
+  //! form and the Newton step found with preconditioned GMRES instead of
+  //! a dense factorization
+  bool mSparseSolve;
+
+  //! tolerance on the residual of the linear solve for the Newton step
+  //! relative to the norm of the right hand side.  Only used by GMRES.
+  double mLinearTol;
+
+  //! maximum number of Sherman-Morrison updates to apply to the inverse
+  //! Jacobian before it is recomputed from a fresh factorization.  Zero
+  //! means factor the Jacobian at every iteration.
+  int mMaxInverseUpdates;
+
   // These next two have to be class variables because we sometimes
   // have multiple logbroyden solvers operating.
   static int mLastPer;                 //<! used to detect when the period has changed, so we can reset mPerIter.
@@ -81,7 +81,8 @@ class LogNRbt: public SolverComponent {
 public:
     LogNRbt( Marketplace* mktplc, World* world, CalcCounter* ccounter, int itmax=250,
              double ftol=1.0e-7 ) : SolverComponent(mktplc,world,ccounter),
-                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true) {}
+                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true),
+                                    mColorJacobian(false) {}
     virtual ~LogNRbt() {}
     
     // SolverComponent methods
@@ -129,6 +130,10 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price 
 
+  //! flag indicating whether finite difference Jacobians should evaluate
+  //! groups of structurally independent markets together
+  bool mColorJacobian;
+
 private:
     static std::string SOLVER_NAME;
 };
@@ -68,6 +68,7 @@
 #include "solution/util/include/ublas-helpers.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "solution/util/include/jacobian-precondition.hpp"
+#include "solution/util/include/sparse-jacobian.hpp"
 
 #if USE_LAPACK
 #include <boost/numeric/bindings/traits/ublas_vector.hpp>
@@ -159,6 +160,19 @@ bool LogBroyden::XMLParse( const DOMNode* aNode ) {
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
         }
+        else if(nodeName == "jacobian-coloring") {
+          mColorJacobian = true;
+        }
+        else if(nodeName == "linear-solver") {
+          // "dense" (the default) or "gmres"
+          mSparseSolve = XMLHelper<std::string>::getValue( curr ) == "gmres";
+        }
+        else if(nodeName == "linear-tol") {
+          mLinearTol = XMLHelper<double>::getValue( curr );
+        }
+        else if(nodeName == "max-inverse-updates") {
+          mMaxInverseUpdates = XMLHelper<int>::getValue( curr );
+        }
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
         }
@@ -243,7 +257,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     }
     
     solverLog << "Initial market state:\nmkt    \tprice   \tsupply  \tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
+    const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
     for(size_t i=0; i<solvables.size(); ++i) {
         solverLog << std::setw( 8 ) << i << "\t"
                   << std::setw( 8 ) << solvables[i].getPrice() << "\t"
@@ -259,7 +273,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     int neval = 0;
 
     // set our initial x from the solutionInfoSet
-    std::vector<SolutionInfo> smkts(solnset.getSolvableSet());
+    const std::vector<SolutionInfo>& smkts = solnset.getSolvableSet();
     if( mLogPricep ) {
       std::transform(smkts.begin(), smkts.end(), x.begin(), SI2lgprice);
     }
@@ -270,6 +284,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     
     // This is the closure that will evaluate the ED function
     LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+    F.setJacobianColoring(mColorJacobian);
     // check the assumptions:  narg==nrtn==nsolv
     if(F.narg() != nsolv || F.nrtn() != nsolv) {
       solverLog.setLevel(ILogger::SEVERE);
@@ -387,6 +402,18 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 #endif
 
   UBMATRIX Btmp(nrow, ncol);
+  // Inverse of B.  When mMaxInverseUpdates > 0 it is kept current
+  // through the Broyden updates with the Sherman-Morrison formula, so
+  // that most iterations need only an O(N^2) matrix-vector product
+  // instead of an O(N^3) factorization.
+  UBMATRIX Binv(nrow, ncol);
+  int ageBinv = -1;   // number of updates applied to Binv since it was computed; -1 if not valid
+  // In sparse mode the Broyden iterations operate on Bsp.  B is still
+  // used as scratch space for the finite difference Jacobian.
+  UBSPMATRIX Bsp;
+  if(mSparseSolve) {
+    sparsifyJacobian(B, Bsp);
+  }
   ILogger &solverLog = ILogger::getLogger("solver_log");
   ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
   worstMarketLog.setLevel( ILogger::DEBUG );
@@ -459,7 +486,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     for(int j=0;j<F.narg();++j) {
       // double bjj= B(j,j);
       // jdiag[j] = bjj;
-      jdiag[j] = B(j,j);
+      jdiag[j] = mSparseSolve ? Bsp(j,j) : B(j,j);
     }
     double jdmax=0.0, jdmin=0.0;
     int jdjmax=0, jdjmin=0;
@@ -468,9 +495,14 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     solverLog << "maxval= " << jdmax << " jmax= " << jdjmax << "  "
               << "minval= " << jdmin << "  jmin= " << jdjmin << "\n";
     
-    axpy_prod(fx,B,gx);         // compute the gradient of F*F (= fx^T * B == B^T * fx)
+    if(mSparseSolve) {
+      sparseTransProd(Bsp, fx, gx);
+    }
+    else {
+      axpy_prod(fx,B,gx);       // compute the gradient of F*F (= fx^T * B == B^T * fx)
                                 // axpy_prod clears gx on entry, so we don't have to do it.
                                 // NB: the order of fx and B in that last call is significant!
+    }
 
     // Check for zero gradient.  This indicates a local minimum in f,
     // from which we are unlikely to escape.  We will need to try
@@ -482,79 +514,140 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       return -3;
     }
 
-    Btmp = B;                   // save the jacobian approximant
-#if USE_LAPACK /* Solve using SVD */
-    int ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
-                                                       B,           // input matrix
-                                                       Ssv,Usv,VTsv); // outputs
-    if(ierr>0) {
-      // svd failed.  It's not even clear under what circumstances
-      // this can happen
-      solverLog.setLevel(ILogger::SEVERE);
-      solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
-      return ierr;
-    }
-
-    // At this point, U, S, and VT contain the SVD of the original Jacobian
-    solverLog.setLevel(ILogger::DEBUG);
-    dx = -1.0*fx; 
-    int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
-
-    solverLog << "\nIteration " << iter << "\nf0= " << f0
-              << "\tnsing= " << nsing
-              << "\nx: " << x << "\nF( x ): " << fx << "\ndx: " << dx << "\n";
-
-#else /* No USE_LAPACK.  Solve using L-U decomposition */
-    int itrial = 0;
-    /* If the L-U decomposition fails the first time around, we will
-       invoke the jacobian preconditioner and try again.  If it fails
-       a second time, we bail out */
-    do {
-      for(size_t i=0; i<p.size(); ++i) {
-        p[i] = i;
-      }
-      int sing = lu_factorize(B,p);
-      if(sing>0) {
-        int fail=1;
-        B = Btmp;           // restore Jacobian
-        if(itrial == 0) {
+    if(mSparseSolve) {
+      /* Solve using preconditioned GMRES.  If the ILU preconditioner
+         breaks down, salvage the Jacobian the same way the L-U branch
+         does and try again once. */
+      int itrial = 0;
+      int gerr;
+      do {
+        dx = -1.0*fx;
+        gerr = gmresSolve(Bsp, dx, mLinearTol, 30, 10*nrow, solverLog);
+        if(gerr > 0) {
+          if(itrial == 0) {
             solverLog << "Salvaging Jacobian.\n";
-            fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
+            densifyJacobian(Bsp, B);
+            int fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
             f0 = inner_prod(fx,fx);
+            sparsifyJacobian(B, Bsp);
 
-            // log the diagonal of the new jacobian
             for(int j=0; j<F.narg(); ++j) {
-                jdiag[j] = B(j,j); 
+              jdiag[j] = Bsp(j,j);
             }
             solverLog << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
+            if(!fail) {
+              // the gradient depends on both B and fx, which may have changed.
+              sparseTransProd(Bsp, fx, gx);
+              continue;
+            }
+          }
+          solverLog.setLevel(ILogger::WARNING);
+          solverLog << "Singular Jacobian:\n" << B << "\n";
+          return gerr;
+        }
+        break;
+      } while(++itrial < 2);
+      // A nonconvergent GMRES still yields a usable search direction
+      // in most cases; the line search will tell us if it doesn't.
+      solverLog << "dx: " << dx << "\n";
+    }
+    else if(ageBinv >= 0) {
+      // The inverse is still good; skip the factorization.
+      Btmp = B;
+      axpy_prod(Binv, -fx, dx);
+      solverLog << "Using updated inverse Jacobian.  Updates since last factorization:  " << ageBinv
+                << "\ndx: " << dx << "\n";
+    }
+    else {
+      Btmp = B;                   // save the jacobian approximant
+#if USE_LAPACK /* Solve using SVD */
+      int ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
+                                                         B,           // input matrix
+                                                         Ssv,Usv,VTsv); // outputs
+      if(ierr>0) {
+        // svd failed.  It's not even clear under what circumstances
+        // this can happen
+        solverLog.setLevel(ILogger::SEVERE);
+        solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
+        return ierr;
+      }
+
+      // At this point, U, S, and VT contain the SVD of the original Jacobian
+      solverLog.setLevel(ILogger::DEBUG);
+      int nsing = svdInvert(Usv,Ssv,VTsv,Binv, solverLog);
+      axpy_prod(Binv, -fx, dx);
+      if(mMaxInverseUpdates > 0) {
+        ageBinv = 0;
+      }
+
+      solverLog << "\nIteration " << iter << "\nf0= " << f0
+                << "\tnsing= " << nsing
+                << "\nx: " << x << "\nF( x ): " << fx << "\ndx: " << dx << "\n";
 
+#else /* No USE_LAPACK.  Solve using L-U decomposition */
+      int itrial = 0;
+      /* If the L-U decomposition fails the first time around, we will
+         invoke the jacobian preconditioner and try again.  If it fails
+         a second time, we bail out */
+      do {
+        for(size_t i=0; i<p.size(); ++i) {
+          p[i] = i;
         }
+        int sing = lu_factorize(B,p);
+        if(sing>0) {
+          int fail=1;
+          B = Btmp;           // restore Jacobian
+          if(itrial == 0) {
+              solverLog << "Salvaging Jacobian.\n";
+              fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
+              f0 = inner_prod(fx,fx);
+
+              // log the diagonal of the new jacobian
+              for(int j=0; j<F.narg(); ++j) {
+                  jdiag[j] = B(j,j); 
+              }
+              solverLog << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
+
+          }
         
-        if( fail ) {
-            solverLog.setLevel(ILogger::WARNING);
-            solverLog << "Singular Jacobian:\n" << B << "\n";
-            return sing;
+          if( fail ) {
+              solverLog.setLevel(ILogger::WARNING);
+              solverLog << "Singular Jacobian:\n" << B << "\n";
+              return sing;
+          }
+        }
+        else {
+          // L-U decomp was successful.  Continue with the next phase of the algorithm.
+          break;
         }
+      } while(++itrial < 2);
+    
+      // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
+      dx = -1.0*fx;
+      try {
+        lu_substitute(B,p,dx);    // solve dx = J^-1 F
       }
-      else {
-        // L-U decomp was successful.  Continue with the next phase of the algorithm.
-        break;
+      catch (const boost::numeric::ublas::internal_logic &err) {
+        // This error seems to be thrown when the Jacobian is
+        // ill-conditioned.  We let it go because often the solver will
+        // muddle through to a solution.  If not, then it will
+        // eventually stop with a genuinely singular matrix.
       }
-    } while(++itrial < 2);
-    
-    // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
-    dx = -1.0*fx;
-    try {
-      lu_substitute(B,p,dx);    // solve dx = J^-1 F
-    }
-    catch (const boost::numeric::ublas::internal_logic &err) {
-      // This error seems to be thrown when the Jacobian is
-      // ill-conditioned.  We let it go because often the solver will
-      // muddle through to a solution.  If not, then it will
-      // eventually stop with a genuinely singular matrix.
-    }
-    solverLog << "dx: " << dx << "\n"; 
+      if(mMaxInverseUpdates > 0) {
+        // Form the inverse from the factorization we already have, so
+        // that subsequent iterations can update it instead of factoring.
+        Binv = boost::numeric::ublas::identity_matrix<double>(nrow);
+        try {
+          lu_substitute(B,p,Binv);
+          ageBinv = 0;
+        }
+        catch (const boost::numeric::ublas::internal_logic &err) {
+          ageBinv = -1;
+        }
+      }
+      solverLog << "dx: " << dx << "\n"; 
 #endif /* USE_LAPACK */
+    } /* mSparseSolve */
 
     // log the proposal step
     solverLog << "Proposal step magnitude dxmag= " << sqrt(inner_prod(dx,dx)) << "\n\n";
@@ -579,6 +672,10 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
         fdjac(F,x,fx,B);
         neval += x.size();
         ageB = 0;  // reset the age on B
+        ageBinv = -1;
+        if(mSparseSolve) {
+          sparsifyJacobian(B, Bsp);
+        }
 
         // Log the diagonal of the new jacobian after the failed line search
         for(int j=0; j<F.narg(); ++j) {
@@ -684,12 +781,38 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     // update B for next iteration
     double fratio_cutoff = 1.0 - 1.0/nrow;
     if(fnew/f0 < fratio_cutoff) { // making adequate progress with the Broyden formula
-      double dx2 = inner_prod(xstep,xstep);
-      UBVECTOR Bdx(F.nrtn());
-      B = Btmp;
-      fxstep -= axpy_prod(B, xstep, Bdx);
-      fxstep /= dx2;
-      B += outer_prod(fxstep, xstep);
+      if(mSparseSolve) {
+        // Schubert's update keeps the sparsity pattern of B
+        sparseBroydenUpdate(Bsp, xstep, fxstep);
+      }
+      else {
+        if(ageBinv >= 0) {
+          // Sherman-Morrison form of the same update applied to B^-1:
+          // Binv += (dx - Binv.dF) X (dx^T.Binv) / (dx^T.Binv.dF)
+          // If the denominator is small relative to its factors the
+          // update is ill-conditioned, so refactor instead.
+          UBVECTOR Hdf(prod(Binv, fxstep));
+          double denom = inner_prod(xstep, Hdf);
+          if(ageBinv < mMaxInverseUpdates &&
+             fabs(denom) > 1.0e-8 * norm_2(xstep) * norm_2(Hdf)) {
+            UBVECTOR sH(prod(xstep, Binv));
+            Hdf = (xstep - Hdf) / denom;
+            Binv += outer_prod(Hdf, sH);
+            ageBinv++;
+          }
+          else {
+            solverLog << "Inverse Jacobian will be refactored.  Updates since last factorization:  "
+                      << ageBinv << "\n";
+            ageBinv = -1;
+          }
+        }
+        double dx2 = inner_prod(xstep,xstep);
+        UBVECTOR Bdx(F.nrtn());
+        B = Btmp;
+        fxstep -= axpy_prod(B, xstep, Bdx);
+        fxstep /= dx2;
+        B += outer_prod(fxstep, xstep);
+      }
       ageB++;                // increment the age of B
     }
     else {
@@ -701,6 +824,10 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
         fdjac(F,xnew,fxnew,B);
         neval += x.size();
         ageB = 0;
+        ageBinv = -1;
+        if(mSparseSolve) {
+          sparsifyJacobian(B, Bsp);
+        }
 
         // Log the results of the Jacobian reset
         for(int j=0; j<F.narg(); ++j) {
@@ -789,8 +916,8 @@ void LogBroyden::reportPSD(UBVECTOR &arptvec, const std::vector<int> &amktids, c
         return;
     }
 
-    std::vector<SolutionInfo> solvable = cSolInfo->getSolvableSet();
-    std::vector<SolutionInfo> unsolvable = cSolInfo->getUnsolvableSet();
+    const std::vector<SolutionInfo>& solvable = cSolInfo->getSolvableSet();
+    const std::vector<SolutionInfo>& unsolvable = cSolInfo->getUnsolvableSet();
 
     unsigned int i;
     unsigned int j;
@@ -130,6 +130,9 @@ bool LogNRbt::XMLParse( const DOMNode* aNode ) {
         }
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
+        }
+        else if(nodeName == "jacobian-coloring") {
+          mColorJacobian = true;
         } 
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
@@ -190,7 +193,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     }
     
     solverLog << "Initial market state:\nmkt\tprice\tsupply\tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
+    const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
     for(size_t i=0; i<solvables.size(); ++i) {
       solverLog << i << "\t" << solvables[i].getPrice()
                 << "\t" << solvables[i].getSupply()
@@ -205,7 +208,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     int neval = 0;
 
     // set our initial x from the solutionInfoSet
-    std::vector<SolutionInfo> smkts(solnset.getSolvableSet());
+    const std::vector<SolutionInfo>& smkts = solnset.getSolvableSet();
     if(mLogPricep)
       std::transform(smkts.begin(), smkts.end(), x.begin(), SI2lgprice);
     else
@@ -213,6 +216,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
 
     // This is the closure that will evaluate the ED function
     LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+    F.setJacobianColoring(mColorJacobian);
 
     // scale the initial guess for use in F
     F.scaleInitInputs(x);
@@ -202,7 +202,7 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     
     // set up some scratch data
     int nmkt = aSolutionSet.getNumSolvable();
-    std::vector<SolutionInfo> solvable = aSolutionSet.getSolvableSet();
+    std::vector<SolutionInfo>& solvable = aSolutionSet.getSolvableSet();
 
     solverLog << "Preconditioning " << nmkt << " markets.\n";
 
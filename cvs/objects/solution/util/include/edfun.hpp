@@ -80,7 +80,7 @@ class LogEDFun : public VecFVec<double,double>
   //! \details This need not (and generally will not) include all of
   //! the markets in the model.  Markets not included in the list will
   //! have their prices held constant.
-  std::vector<SolutionInfo> mkts;
+  std::vector<SolutionInfo>& mkts;
 
   SolutionInfoSet &solnset;         //!< All SolutionInfo objects,
                                     //!including ones not being
@@ -94,6 +94,14 @@ class LogEDFun : public VecFVec<double,double>
                        //!required.
   int period;
   bool mLogPricep;               //!< Flag indicating whether inputs are prices or log-prices
+  bool mColorJacobian;           //!< Flag indicating whether jacobianSparsity should group markets
+
+  //! Groups of structurally independent markets (computed on first use)
+  std::vector<std::vector<int> > mGroups;
+  //! The markets whose excess demand may be affected by each market's price
+  std::vector<std::vector<int> > mRows;
+  //! The activities to recalculate when perturbing each group in mGroups
+  std::vector<std::vector<IActivity*> > mGroupCalcLists;
 
   // diagnostic variables
   std::vector<double> mstate;
@@ -104,7 +112,11 @@ public:
   virtual void operator()(const UBVECTOR<double> &x, UBVECTOR<double> &fx, const int partj=-1);
   virtual void partial(int ip);
   virtual double partialSize(int ip) const;
+  virtual bool jacobianSparsity(std::vector<std::vector<int> > &aGroups,
+                                std::vector<std::vector<int> > &aRows);
+  virtual void partialGroup(const UBVECTOR<double> &x, UBVECTOR<double> &fx, int aGroup);
   void scaleInitInputs(UBVECTOR<double> &ax);
+  void setJacobianColoring(bool aColorJacobian);
 
   // Constants to protect against overflow: 
   static const double PMAX;            //!< Greatest allowable price
@@ -116,6 +128,10 @@ protected:
   // scale factors for input and output
   UBVECTOR<double> mxscl;
   UBVECTOR<double> mfxscl;
+
+  void evaluate(const UBVECTOR<double> &x, UBVECTOR<double> &fx,
+                const std::vector<int> *aPartialCols,
+                const std::vector<IActivity*> *aAffectedNodes);
     
 };  
 
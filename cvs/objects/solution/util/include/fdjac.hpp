@@ -104,6 +104,50 @@ inline void jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
 }
 
 
+/*!
+ * Compute the columns of a Jacobian matrix belonging to a group of
+ * structurally independent columns using a single function evaluation.
+ * Every element of x in the group is perturbed at once, and the change
+ * in each element of F is attributed to the one column in the group
+ * that can affect it according to the sparsity pattern.  Entries outside
+ * of the pattern are set to zero.
+ * \param[in] aGroup: index of the group (as returned by F.jacobianSparsity)
+ * \param[in] aCols: the columns in the group
+ * \param[in] aRows: for each column, the rows that may depend on it
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacgroup(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                     const UBLAS::vector<FTYPE> &fx, int aGroup, const std::vector<int> &aCols,
+                     const std::vector<std::vector<int> > &aRows,
+                     UBLAS::matrix<FTYPE,MTRAIT> &J) {
+  const FTYPE heps = 1.0e-6;
+  const FTYPE TINY = 1.0e-6;
+  UBLAS::vector<FTYPE> xx(x); // temporary, so we can respect the const on x
+  UBLAS::vector<FTYPE> fxx(fx.size());        // hold the values of F(xx)
+  std::vector<FTYPE> hinv(aCols.size());
+  for(size_t k=0; k<aCols.size(); ++k) {
+    int j = aCols[k];
+    FTYPE t = xx[j];
+    xx[j] = t + heps * (fabs(t)+TINY);
+    hinv[k] = 1.0/(xx[j]-t);    // (t+h)-t to reduce roundoff error
+  }
+
+  F.partial(aCols[0]);          // hint to the function that this is a partial derivative calculation
+  F.partialGroup(xx, fxx, aGroup);
+
+  for(size_t k=0; k<aCols.size(); ++k) {
+    int j = aCols[k];
+    for(size_t i=0; i<fxx.size(); ++i) {
+      J(i,j) = 0.0;
+    }
+    const std::vector<int> &rows = aRows[j];
+    for(size_t r=0; r<rows.size(); ++r) {
+      J(rows[r],j) = (fxx[rows[r]] - fx[rows[r]]) * hinv[k];
+    }
+  }
+}
+
+
 /*!
  * Compute the Jacobian of a vector function F at point x.
  * \param[in] F: The function to have its Jacobian calculated
@@ -151,18 +195,39 @@ void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
   jacTimer.start();
     if(usepartial) { scenario->getManageStateVariables()->setPartialDeriv(true); }
   
+  // If the function can tell us which columns are structurally
+  // independent we can compute each group of them with a single
+  // evaluation.
+  std::vector<std::vector<int> > groups;
+  std::vector<std::vector<int> > rows;
+  bool usegroups = usepartial && !diagnostic && F.jacobianSparsity(groups, rows);
+
 #if !GCAM_PARALLEL_ENABLED
-  for(size_t j=0; j<x.size(); ++j) {
-    jacol(F, x, fx, j, J, usepartial, diagnostic);
+  if(usegroups) {
+    for(size_t g=0; g<groups.size(); ++g) {
+      jacgroup(F, x, fx, g, groups[g], rows, J);
+    }
+  }
+  else {
+    for(size_t j=0; j<x.size(); ++j) {
+      jacol(F, x, fx, j, J, usepartial, diagnostic);
+    }
   }
 #else
     tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
     tbb::task_group tg;
     threadPool.execute([&](){
         tg.run([&](){
-            tbb::parallel_for_each( x, [&]( const FTYPE& j ) {
-                jacol(F, x, fx, (&j - &x[0]), J, usepartial, 0/*diagnostic*/);
-            });
+            if(usegroups) {
+                tbb::parallel_for_each( groups, [&]( const std::vector<int>& group ) {
+                    jacgroup(F, x, fx, (&group - &groups[0]), group, rows, J);
+                });
+            }
+            else {
+                tbb::parallel_for_each( x, [&]( const FTYPE& j ) {
+                    jacol(F, x, fx, (&j - &x[0]), J, usepartial, 0/*diagnostic*/);
+                });
+            }
         });
     });
     threadPool.execute([&tg](){ tg.wait(); });
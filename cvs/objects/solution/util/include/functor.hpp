@@ -45,6 +45,7 @@
  */
 
 #include <iostream>
+#include <vector>
 #include <boost/numeric/ublas/vector.hpp> 
 
 #define UBVECTOR boost::numeric::ublas::vector
@@ -110,6 +111,42 @@ public:
    * derivative.
    */
   virtual double partialSize(int ip) const {return 1.0;}
+  /*!
+   * Partition the elements of the input vector into groups whose partial
+   * derivatives can be computed from a single function evaluation.
+   *
+   * Two elements may be placed in the same group only if no element of
+   * the return vector can be affected by both of them.  A function that
+   * knows its sparsity structure can then perturb every element of a
+   * group at once (see partialGroup) and assign each change in the
+   * return vector to the single element of the group that could have
+   * caused it.  The default implementation has no structural
+   * information and returns false, in which case callers should fall
+   * back to one evaluation per element.
+   *
+   * \param[out] aGroups: the input vector indices in each group
+   * \param[out] aRows: for each input vector index, the sorted indices
+   *             of the return vector that may depend on it
+   * \return true if the groups have been set
+   */
+  virtual bool jacobianSparsity(std::vector<std::vector<int> > &aGroups,
+                                std::vector<std::vector<int> > &aRows) {return false;}
+  /*!
+   * Evaluate the function with every input element in a group from
+   * jacobianSparsity perturbed simultaneously.
+   *
+   * Like operator() with partj set, this should only be called after
+   * partial() has been called with one of the indices in the group.
+   * The default implementation does a full evaluation.
+   *
+   * \param[in] arg: argument vector
+   * \param[out] rval: return value vector
+   * \param[in] aGroup: index of the group (as returned by jacobianSparsity)
+   *             being perturbed
+   */
+  virtual void partialGroup(const UBVECTOR<Ta> &arg, UBVECTOR<Tr> &rval, int aGroup) {
+    operator()(arg, rval);
+  }
   /*!
    * Turns on implementation-defined diagnostics (default is no-op)
    */
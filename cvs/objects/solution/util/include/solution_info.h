@@ -77,9 +77,9 @@ class SolutionInfo {
     }
 public:
 #if GCAM_PARALLEL_ENABLED
-    SolutionInfo( Market* linkedMarket, const std::vector<IActivity*>& aDependenicies, GcamFlowGraph* aFlowGraph );
+    SolutionInfo( Market* linkedMarket, const int aMarketNumber, const std::vector<IActivity*>& aDependenicies, GcamFlowGraph* aFlowGraph );
 #else
-    SolutionInfo( Market* linkedMarket, const std::vector<IActivity*>& aDependenicies );
+    SolutionInfo( Market* linkedMarket, const int aMarketNumber, const std::vector<IActivity*>& aDependenicies );
 #endif
     bool operator==( const SolutionInfo& rhs ) const;
     bool operator!=( const SolutionInfo& rhs ) const;
@@ -133,6 +133,8 @@ public:
     double getForecastDemand() const;
 
     int getSerialNumber( void ) const;
+
+    int getMarketNumber() const;
     
     const IInfo* getMarketInfo() const;
 #if GCAM_PARALLEL_ENABLED
@@ -158,6 +160,7 @@ private:
     bool bracketed; //!< Bracketed or unbracketed.
     bool mBisected;
     Market* linkedMarket; //!< Linked market. 
+    int mMarketNumber; //!< The index of the linked market in the Marketplace.
     double XL;      //!< left bracket
     double XR;      //!< right bracket
     double EDL;     //!< excess demand for left bracket
@@ -80,7 +80,7 @@ public:
     typedef std::vector<SolutionInfo>::iterator SetIterator;
     typedef std::vector<SolutionInfo>::const_iterator ConstSetIterator;
     SolutionInfoSet( Marketplace* marketplace );
-    SolutionInfoSet( const std::vector<SolutionInfo> aSolutionSet );
+    SolutionInfoSet( const std::vector<SolutionInfo>& aSolutionSet );
     void init( const unsigned int aPeriod, const double aDefaultSolutionTolerance, const double aDefaultSolutionFloor,
                const SolutionInfoParamParser* aSolutionInfoParamParser );
     UpdateCode updateSolvable( const ISolutionInfoFilter* aSolutionInfoFilter );
@@ -104,8 +104,9 @@ public:
     SolutionInfo& getSolvable( unsigned int index );
     const SolutionInfo& getAny( unsigned int index ) const;
     SolutionInfo& getAny( unsigned int index );
-    std::vector<SolutionInfo> getSolvableSet() const;
-    std::vector<SolutionInfo> getUnsolvableSet() const;
+    const std::vector<SolutionInfo>& getSolvableSet() const;
+    std::vector<SolutionInfo>& getSolvableSet();
+    const std::vector<SolutionInfo>& getUnsolvableSet() const;
     std::vector<SolutionInfo> getSolvedSet() const;
     std::vector<SolutionInfo> getUnsolvedSet() const;
     bool isAllSolved();
@@ -123,7 +124,6 @@ private:
     unsigned int period;
     Marketplace* marketplace;
     std::vector<SolutionInfo> solvable;
-    std::vector<SolutionInfo> unsolved; // solvable markets that are not currently solved
     std::vector<SolutionInfo> unsolvable;
     void print( std::ostream& out ) const;
 };
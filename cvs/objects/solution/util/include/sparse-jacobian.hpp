@@ -0,0 +1,111 @@
+#ifndef SPARSE_JACOBIAN_HPP_
+#define SPARSE_JACOBIAN_HPP_
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file sparse-jacobian.hpp
+ * \ingroup Solution
+ * \brief Compressed sparse row Jacobian storage and solvers for the Broyden solver.
+ * \details The Jacobian is held in a ublas compressed_matrix, which uses the
+ *          compressed sparse row (CSR) layout.  The sparsity pattern is fixed
+ *          when the matrix is built from a finite-difference Jacobian and is
+ *          preserved by the Broyden update, so the cost of each iteration scales
+ *          with the number of structural non-zeros instead of N^3.
+ */
+
+#include <iostream>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+
+#define UBLAS boost::numeric::ublas
+
+typedef UBLAS::compressed_matrix<double, UBLAS::row_major> UBSPMATRIX;
+
+/*!
+ * Convert a dense Jacobian into CSR storage.
+ * \details Exact zeros are dropped since the finite-difference Jacobian
+ *          contains an exact zero for any market that was not recalculated
+ *          for a partial derivative.  The diagonal is always kept so that the
+ *          incomplete factorization has a pivot for every row.
+ * \param[in] J: the dense Jacobian
+ * \param[out] B: the sparse Jacobian
+ */
+template <class MTRAIT>
+void sparsifyJacobian(const UBLAS::matrix<double,MTRAIT> &J, UBSPMATRIX &B)
+{
+  size_t nnz = 0;
+  for(size_t i=0; i<J.size1(); ++i) {
+    for(size_t j=0; j<J.size2(); ++j) {
+      if(J(i,j) != 0.0 || i == j) {
+        ++nnz;
+      }
+    }
+  }
+  B = UBSPMATRIX(J.size1(), J.size2(), nnz);
+  for(size_t i=0; i<J.size1(); ++i) {
+    for(size_t j=0; j<J.size2(); ++j) {
+      if(J(i,j) != 0.0 || i == j) {
+        B.push_back(i, j, J(i,j));
+      }
+    }
+  }
+}
+
+/*!
+ * Copy a CSR Jacobian into dense storage.
+ * \param[in] B: the sparse Jacobian
+ * \param[out] J: the dense Jacobian, which must already be sized
+ */
+template <class MTRAIT>
+void densifyJacobian(const UBSPMATRIX &B, UBLAS::matrix<double,MTRAIT> &J)
+{
+  J.clear();
+  for(UBSPMATRIX::const_iterator1 row = B.begin1(); row != B.end1(); ++row) {
+    for(UBSPMATRIX::const_iterator2 elem = row.begin(); elem != row.end(); ++elem) {
+      J(elem.index1(), elem.index2()) = *elem;
+    }
+  }
+}
+
+void sparseTransProd(const UBSPMATRIX &B, const UBLAS::vector<double> &v, UBLAS::vector<double> &out);
+
+void sparseBroydenUpdate(UBSPMATRIX &B, const UBLAS::vector<double> &dx, const UBLAS::vector<double> &df);
+
+int gmresSolve(const UBSPMATRIX &A, UBLAS::vector<double> &b, double tol, int restart, int maxiter,
+               std::ostream &logf);
+
+#undef UBLAS
+
+#endif
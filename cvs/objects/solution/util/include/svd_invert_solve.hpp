@@ -35,6 +35,12 @@
 
 #define UBLAS boost::numeric::ublas
 
+int svdInvert(const UBLAS::matrix<double,UBLAS::column_major> &U,
+              const UBLAS::vector<double> &S,
+              const UBLAS::matrix<double,UBLAS::column_major> &VT,
+              UBLAS::matrix<double,UBLAS::column_major> &Ainv,
+              std::ostream &logf);
+
 int svdInvertSolve(const UBLAS::matrix<double,UBLAS::column_major> &U,
                      const UBLAS::vector<double> &S,
                      const UBLAS::matrix<double,UBLAS::column_major> &VT,
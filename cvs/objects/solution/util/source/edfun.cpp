@@ -34,7 +34,9 @@
 #include <math.h>
 #include <assert.h>
 #include <set>
+#include <map>
 #include <vector>
+#include <algorithm>
 #include "solution/util/include/edfun.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "containers/include/iactivity.h"
@@ -42,6 +44,7 @@
 #include "util/logger/include/ilogger.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/manage_state_variables.hpp"
+#include "containers/include/market_dependency_finder.h"
 
 #include "util/base/include/timer.h"
 
@@ -59,7 +62,8 @@ LogEDFun::LogEDFun(SolutionInfoSet &sisin,
     mkts(sisin.getSolvableSet()),
     solnset(sisin),
     world(w), mktplc(m), period(per),
-    mLogPricep(aLogPricep)
+    mLogPricep(aLogPricep),
+    mColorJacobian(false)
 {
     na=nr=mkts.size();
     mdiagnostic=false;
@@ -146,6 +150,147 @@ double LogEDFun::partialSize(int ip) const
 }
 
 void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, const int partj)
+{
+  if(partj < 0) {
+    evaluate(ax, fx, 0, 0);
+  }
+  else {
+    const std::vector<int> partialCols(1, partj);
+    evaluate(ax, fx, &partialCols, &mkts[partj].getDependencies());
+  }
+}
+
+void LogEDFun::partialGroup(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, int aGroup)
+{
+  evaluate(ax, fx, &mGroups[aGroup], &mGroupCalcLists[aGroup]);
+}
+
+/*!
+ * \brief Turn on or off the use of structurally independent column groups
+ *        when calculating partial derivatives.
+ * \param aColorJacobian Whether jacobianSparsity should provide groups.
+ */
+void LogEDFun::setJacobianColoring(bool aColorJacobian)
+{
+  mColorJacobian = aColorJacobian;
+}
+
+/*!
+ * \brief Group the solvable markets into sets whose partial derivatives can be
+ *        calculated with a single partial model evaluation.
+ * \details The market-to-market sparsity pattern is taken from
+ *          MarketDependencyFinder::getCoupledMarkets.  Columns that share any
+ *          coupled row are given different colors using a greedy, largest-first
+ *          coloring.  The list of activities to calculate for each group is the
+ *          union of the activities for its markets in the global ordering.  The
+ *          results are computed the first time they are requested and reused
+ *          for the lifetime of this object since the set of markets is fixed.
+ * \param aGroups The market indices in each group.
+ * \param aRows The indices of the markets each market is coupled to.
+ * \return True if Jacobian coloring has been enabled.
+ */
+bool LogEDFun::jacobianSparsity(std::vector<std::vector<int> > &aGroups,
+                                std::vector<std::vector<int> > &aRows)
+{
+  if(!mColorJacobian) {
+    return false;
+  }
+
+  if(mGroups.empty()) {
+    MarketDependencyFinder* depFinder = mktplc->getDependencyFinder();
+
+    // map market numbers to their index in the solvable set
+    std::map<int, int> mktIndex;
+    for(int i=0; i<na; ++i) {
+      mktIndex[mkts[i].getMarketNumber()] = i;
+    }
+
+    // rows which may be affected by each column
+    mRows.resize(na);
+    std::vector<std::vector<int> > colsByRow(na);
+    for(int j=0; j<na; ++j) {
+      const std::vector<int>& coupled = depFinder->getCoupledMarkets(mkts[j].getMarketNumber());
+      for(size_t k=0; k<coupled.size(); ++k) {
+        std::map<int, int>::const_iterator idx = mktIndex.find(coupled[k]);
+        if(idx != mktIndex.end()) {
+          mRows[j].push_back((*idx).second);
+          colsByRow[(*idx).second].push_back(j);
+        }
+      }
+      std::sort(mRows[j].begin(), mRows[j].end());
+    }
+
+    // greedy coloring, taking the columns with the most rows first
+    std::vector<int> order(na);
+    for(int j=0; j<na; ++j) {
+      order[j] = j;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](int aLHS, int aRHS) { return mRows[aLHS].size() > mRows[aRHS].size(); });
+    std::vector<int> color(na, -1);
+    std::vector<int> usedBy;    // the last column to mark each color as unavailable
+    for(int k=0; k<na; ++k) {
+      int j = order[k];
+      for(size_t r=0; r<mRows[j].size(); ++r) {
+        const std::vector<int>& cols = colsByRow[mRows[j][r]];
+        for(size_t c=0; c<cols.size(); ++c) {
+          if(color[cols[c]] >= 0) {
+            usedBy[color[cols[c]]] = j;
+          }
+        }
+      }
+      int newColor = 0;
+      while(newColor < static_cast<int>(usedBy.size()) && usedBy[newColor] == j) {
+        ++newColor;
+      }
+      if(newColor == static_cast<int>(usedBy.size())) {
+        usedBy.push_back(-1);
+        mGroups.push_back(std::vector<int>());
+      }
+      color[j] = newColor;
+      mGroups[newColor].push_back(j);
+    }
+
+    // activities to calculate for each group, kept in the global order
+    const std::vector<IActivity*> globalOrdering = depFinder->getOrdering();
+    mGroupCalcLists.resize(mGroups.size());
+    for(size_t g=0; g<mGroups.size(); ++g) {
+      std::sort(mGroups[g].begin(), mGroups[g].end());
+      std::set<IActivity*> toCalc;
+      for(size_t k=0; k<mGroups[g].size(); ++k) {
+        const std::vector<IActivity*>& deps = mkts[mGroups[g][k]].getDependencies();
+        toCalc.insert(deps.begin(), deps.end());
+      }
+      for(size_t a=0; a<globalOrdering.size() && !toCalc.empty(); ++a) {
+        std::set<IActivity*>::iterator it = toCalc.find(globalOrdering[a]);
+        if(it != toCalc.end()) {
+          mGroupCalcLists[g].push_back(*it);
+          toCalc.erase(it);
+        }
+      }
+    }
+
+    ILogger& solverlog = ILogger::getLogger("solver_log");
+    solverlog.setLevel(ILogger::NOTICE);
+    solverlog << "Jacobian coloring: " << na << " markets in " << mGroups.size() << " groups." << std::endl;
+  }
+
+  aGroups = mGroups;
+  aRows = mRows;
+  return true;
+}
+
+/*!
+ * \brief Evaluate the excess demands.
+ * \param ax The (scaled) inputs.
+ * \param fx The (scaled) outputs.
+ * \param aPartialCols If not null the indices of the inputs that changed for a
+ *                     partial derivative evaluation, otherwise a full evaluation is done.
+ * \param aAffectedNodes The activities to recalculate for a partial derivative evaluation.
+ */
+void LogEDFun::evaluate(const UBVECTOR<double> &ax, UBVECTOR<double> &fx,
+                        const std::vector<int> *aPartialCols,
+                        const std::vector<IActivity*> *aAffectedNodes)
 {
   assert(ax.size() == mkts.size());
   assert(fx.size() == mkts.size());
@@ -171,7 +316,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
    **** point.
    ****/
   
-  if(partj < 0) {               // not a partial derivative calculation
+  if(!aPartialCols) {           // not a partial derivative calculation
     /****
      * 1A Set the model inputs using the solutionInfo objects (full eval version)
      ****/
@@ -225,10 +370,13 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
       ILogger &solverlog = ILogger::getLogger("solver_log");
       solverlog.setLevel(ILogger::DEBUG);
 
-      solverlog << "j= " << partj <<"\tprice  \tsupply \tdemand\tmarket"
-                << "old   \t" << mkts[partj].getPrice() << "\t" << mkts[partj].getSupply()
-                << "\t" << mkts[partj].getDemand()
-                << "\t" << mkts[partj].getName() << "\n";
+      for(size_t k=0; k<aPartialCols->size(); ++k) {
+        int partj = (*aPartialCols)[k];
+        solverlog << "j= " << partj <<"\tprice  \tsupply \tdemand\tmarket"
+                  << "old   \t" << mkts[partj].getPrice() << "\t" << mkts[partj].getSupply()
+                  << "\t" << mkts[partj].getDemand()
+                  << "\t" << mkts[partj].getName() << "\n";
+      }
     }
     
     // In theory the loop over markets is unnecessary, and we need
@@ -247,17 +395,19 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
       }
     }
     else {
-        // During a partial calc only the price of the partj'th element should
+        // During a partial calc only the prices of the partial elements should
         // change and the rest were reset from stored values.  In theory
         // those reset prices are the same as in x however there may be some
         // slight differences due to roundoff error.
-        mkts[partj].setPrice(x[partj]);
+        for(size_t k=0; k<aPartialCols->size(); ++k) {
+          mkts[(*aPartialCols)[k]].setPrice(x[(*aPartialCols)[k]]);
+        }
     }
 
     /****
      * 2B Evaluate the model (partial derivative version)
      ****/
-    const std::vector<IActivity*>& affectedNodes = mkts[partj].getDependencies();
+    const std::vector<IActivity*>& affectedNodes = *aAffectedNodes;
     /* \invariant At least one node is affected */
     assert(!affectedNodes.empty());
     edfunMiscTimer.stop();
@@ -274,9 +424,12 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
       ILogger &solverlog = ILogger::getLogger("solver_log");
       solverlog.setLevel(ILogger::DEBUG);
       
-      solverlog << "new   \t" << mkts[partj].getPrice() << "\t" << mkts[partj].getSupply()
-                << "\t" << mkts[partj].getDemand()
-                << "\t" << mkts[partj].getName() << "\n";
+      for(size_t k=0; k<aPartialCols->size(); ++k) {
+        int partj = (*aPartialCols)[k];
+        solverlog << "new   \t" << mkts[partj].getPrice() << "\t" << mkts[partj].getSupply()
+                  << "\t" << mkts[partj].getDemand()
+                  << "\t" << mkts[partj].getName() << "\n";
+      }
     }
   }
 
@@ -53,14 +53,15 @@ using namespace std;
 
 //! Constructor
 #if GCAM_PARALLEL_ENABLED
-SolutionInfo::SolutionInfo( Market* aLinkedMarket, const vector<IActivity*>& aDependencies, GcamFlowGraph* aFlowGraph )
+SolutionInfo::SolutionInfo( Market* aLinkedMarket, const int aMarketNumber, const vector<IActivity*>& aDependencies, GcamFlowGraph* aFlowGraph )
 #else
-SolutionInfo::SolutionInfo( Market* aLinkedMarket, const vector<IActivity*>& aDependencies )
+SolutionInfo::SolutionInfo( Market* aLinkedMarket, const int aMarketNumber, const vector<IActivity*>& aDependencies )
 #endif
 :
 bracketed( false ),
 mBisected( false ),
 linkedMarket( aLinkedMarket ),
+mMarketNumber( aMarketNumber ),
 XL( 0 ),
 XR( 0 ),
 EDL( 0 ),
@@ -628,3 +629,13 @@ int SolutionInfo::getSerialNumber( void ) const
 {
     return linkedMarket->getSerialNumber();
 }
+
+/*!
+ * \brief Get the index of the linked market in the Marketplace.
+ * \details Unlike the serial number this index is stable across model periods
+ *          and is the number used by the MarketDependencyFinder.
+ * \return The market number of the linked market.
+ */
+int SolutionInfo::getMarketNumber() const {
+    return mMarketNumber;
+}
@@ -40,6 +40,8 @@
 #include "util/base/include/definitions.h"
 #include <cassert>
 #include <algorithm>
+#include <iterator>
+#include <stdexcept>
 #include "util/base/include/util.h"
 #include "solution/util/include/solution_info_set.h"
 #include "solution/util/include/solution_info.h"
@@ -64,7 +66,7 @@ marketplace( aMarketplace )
 }
 
 //! Constructor for new solution set
-SolutionInfoSet::SolutionInfoSet( const vector<SolutionInfo> aSolutionSet ): solvable( aSolutionSet )
+SolutionInfoSet::SolutionInfoSet( const vector<SolutionInfo>& aSolutionSet ): solvable( aSolutionSet )
 {
 }
 
@@ -95,19 +97,31 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
     // Create and initialize a SolutionInfo object for each market.
     typedef vector<Market*>::const_iterator ConstMarketIterator;
     MarketDependencyFinder* depFinder = marketplace->getDependencyFinder();
+#if GCAM_PARALLEL_ENABLED
+    // Generating a flow graph for each market does not typically get paid back in
+    // terms of time saved while calculating partial derivatives, at least in a single
+    // scenario run, so they are only generated if requested.  When they are they
+    // are all built up front in parallel and reused in subsequent periods.
+    const bool useMarketFlowGraphs = Configuration::getInstance()->getBool( "parallel-market-flow-graphs", false, false );
+    if( useMarketFlowGraphs ) {
+        vector<int> solvableMarkets;
+        for( ConstMarketIterator iter = marketsToSolve.begin(); iter != marketsToSolve.end(); ++iter ){
+            if( (*iter)->isSolvable() ) {
+                solvableMarkets.push_back( iter - marketsToSolve.begin() );
+            }
+        }
+        depFinder->createMarketFlowGraphs( solvableMarkets );
+    }
+#endif
     for( ConstMarketIterator iter = marketsToSolve.begin(); iter != marketsToSolve.end(); ++iter ){
         const bool isSolvable = (*iter)->isSolvable();
         const int marketNumber = iter - marketsToSolve.begin();
         const vector<IActivity*> partialList = isSolvable ? depFinder->getOrdering( marketNumber ) : vector<IActivity*>();
 #if GCAM_PARALLEL_ENABLED
-        // TODO: As it turns out the extra time generating these graphs does not typically
-        // get paid back in terms of time saved while calculating partial derivatives.  At
-        // least in a single scenario run.  We need to come up with some methodology to figure
-        // out when it is beneficial to do this or not until then we are not generating any.
-        SolutionInfo currInfo( *iter, partialList, 
-               /*isSolvable ? depFinder->getFlowGraph( marketNumber ) :*/ 0 );
+        SolutionInfo currInfo( *iter, marketNumber, partialList, 
+               isSolvable && useMarketFlowGraphs ? depFinder->getFlowGraph( marketNumber ) : 0 );
 #else
-        SolutionInfo currInfo( *iter, partialList );
+        SolutionInfo currInfo( *iter, marketNumber, partialList );
 #endif
         currInfo.init( aDefaultSolutionTolerance, aDefaultSolutionFloor,
                        aSolutionInfoParamParser->getSolutionInfoValuesForMarket( (*iter)->getGoodName(), (*iter)->getRegionName(),
@@ -131,38 +145,37 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
     solverLog.setLevel( ILogger::DEBUG );
     solverLog << "Updating the solvable set." << endl;
 
-    // Iterate through the solvable markets and determine if any are now unsolvable.
-    for( SetIterator iter = solvable.begin(); iter != solvable.end(); ){
+    // Partition both vectors in a single pass each, moving rather than copying
+    // the SolutionInfo objects.  The resulting order matches moving markets one
+    // at a time: kept solvable markets followed by newly added ones, and kept
+    // unsolvable markets followed by newly removed ones.
+    vector<SolutionInfo> newSolvable;
+    vector<SolutionInfo> newUnsolvable;
+    vector<SolutionInfo> removed;
+    newSolvable.reserve( solvable.size() + unsolvable.size() );
+    newUnsolvable.reserve( solvable.size() + unsolvable.size() );
+    for( SetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ){
         // If it should not be solved for the current method, move it to the unsolvable vector.
         if( !aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            unsolvable.push_back( *iter );
-
             // Print a debugging log message.
             solverLog << iter->getName() << " was removed from the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = solvable.erase( iter );
+            removed.push_back( std::move( *iter ) );
 
             // Update the return code.
             code = REMOVED;
         }
         else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+            newSolvable.push_back( std::move( *iter ) );
         }
     }
 
-    // Loop through the unsolvable set to see if they should be added to the solved. 
-    // This will double check markets that were just added, slightly inefficient.
-    for( SetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ){
+    // Loop through the unsolvable set to see if they should be added to the solved.
+    for( SetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ++iter ){
         // If it should be solved for the current method, move it to the solvable vector.
         if( aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            solvable.push_back( *iter );
             // Print a debugging log message.
             solverLog << iter->getName() << " was added to the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = unsolvable.erase( iter );
+            newSolvable.push_back( std::move( *iter ) );
 
             // Update return code.
             if( code == UNCHANGED || ADDED ){
@@ -173,10 +186,13 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
             }
         }
         else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+            newUnsolvable.push_back( std::move( *iter ) );
         }
     }
+    std::move( removed.begin(), removed.end(), back_inserter( newUnsolvable ) );
+
+    solvable.swap( newSolvable );
+    unsolvable.swap( newUnsolvable );
     return code;
 }
 
@@ -388,13 +404,23 @@ const SolutionInfo& SolutionInfoSet::getSolvable( unsigned int index ) const {
     return solvable.at( index );
 }
 
-//! Get the solvable set (may not be solved).
-vector<SolutionInfo> SolutionInfoSet::getSolvableSet() const{
+//! Get a reference to the solvable set (may not be solved).
+const vector<SolutionInfo>& SolutionInfoSet::getSolvableSet() const{
+    return solvable;
+}
+
+/*!
+ * \brief Get a mutable reference to the solvable set (may not be solved).
+ * \details Callers may change the SolutionInfo objects, for instance to set prices,
+ *          but must not add or remove elements.  The reference remains valid
+ *          across calls to updateSolvable however its contents will change.
+ */
+vector<SolutionInfo>& SolutionInfoSet::getSolvableSet(){
     return solvable;
 }
 
-//! Get the unsolvable set
-vector<SolutionInfo> SolutionInfoSet::getUnsolvableSet() const {
+//! Get a reference to the unsolvable set
+const vector<SolutionInfo>& SolutionInfoSet::getUnsolvableSet() const {
     return unsolvable;
 }
 
@@ -419,15 +445,14 @@ vector<SolutionInfo> SolutionInfoSet::getSolvedSet() const{
     return solvedSet;
 }
 
-//! Const getter which references the unsolved vector.
+//! Non-Const getter which references the index'th unsolved solvable market.
 SolutionInfo& SolutionInfoSet::getUnsolved( unsigned int index ) {
-    unsolved.clear();
     for( SetIterator curr = solvable.begin(); curr != solvable.end(); ++curr ){
-        if( !curr->isSolved() ){
-            unsolved.push_back( *curr );
+        if( !curr->isSolved() && index-- == 0 ){
+            return *curr;
         }
     }
-    return unsolved.at( index );
+    throw out_of_range( "SolutionInfoSet::getUnsolved" );
 }
  
 //! Get the unsolved set.
@@ -0,0 +1,323 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file sparse-jacobian.cpp
+ * \ingroup Solution
+ * \brief Sparse Jacobian update and iterative linear solver for the Broyden solver.
+ */
+
+#include <cmath>
+#include <vector>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+
+#include "solution/util/include/sparse-jacobian.hpp"
+
+namespace ublas = boost::numeric::ublas;
+
+namespace {
+  /*!
+   * Incomplete L-U factorization with zero fill-in, ILU(0).
+   * \details The factors share the sparsity pattern of A.  L has an
+   *          implicit unit diagonal.  The column indices within each
+   *          row of a compressed_matrix are sorted, which the
+   *          factorization relies on.
+   * \param[in] A: the matrix to factor
+   * \param[out] lu: the packed factors, stored with A's pattern
+   * \param[out] diag: position of the diagonal element of each row in lu
+   * \return 0 on success, or the (1-based) row with a zero pivot
+   */
+  int ilu0(const UBSPMATRIX &A, std::vector<double> &lu, std::vector<size_t> &diag)
+  {
+    const size_t n = A.size1();
+    const UBSPMATRIX::index_array_type &rowptr = A.index1_data();
+    const UBSPMATRIX::index_array_type &colidx = A.index2_data();
+    const size_t nnz = A.nnz();
+
+    lu.assign(A.value_data().begin(), A.value_data().begin() + nnz);
+    diag.assign(n, nnz);
+    // position of each column in the row currently being eliminated
+    std::vector<size_t> colpos(n, nnz);
+
+    for(size_t i=0; i<n; ++i) {
+      for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+        colpos[colidx[p]] = p;
+        if(colidx[p] == i) {
+          diag[i] = p;
+        }
+      }
+
+      for(size_t p=rowptr[i]; p<rowptr[i+1] && colidx[p] < i; ++p) {
+        size_t k = colidx[p];
+        lu[p] /= lu[diag[k]];
+        double lik = lu[p];
+        // subtract lik * (row k of U), restricted to the pattern of row i
+        for(size_t q=diag[k]+1; q<rowptr[k+1]; ++q) {
+          size_t pos = colpos[colidx[q]];
+          if(pos != nnz) {
+            lu[pos] -= lik * lu[q];
+          }
+        }
+      }
+
+      for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+        colpos[colidx[p]] = nnz;
+      }
+
+      if(diag[i] == nnz || lu[diag[i]] == 0.0) {
+        return i+1;
+      }
+    }
+    return 0;
+  }
+
+  /*!
+   * Apply the ILU(0) preconditioner, solving L U z = r in place.
+   */
+  void ilu0Solve(const UBSPMATRIX &A, const std::vector<double> &lu, const std::vector<size_t> &diag,
+                 ublas::vector<double> &z)
+  {
+    const size_t n = A.size1();
+    const UBSPMATRIX::index_array_type &rowptr = A.index1_data();
+    const UBSPMATRIX::index_array_type &colidx = A.index2_data();
+
+    // forward substitution with the unit lower triangle
+    for(size_t i=0; i<n; ++i) {
+      double sum = z[i];
+      for(size_t p=rowptr[i]; p<diag[i]; ++p) {
+        sum -= lu[p] * z[colidx[p]];
+      }
+      z[i] = sum;
+    }
+    // back substitution with the upper triangle
+    for(size_t i=n; i-- > 0;) {
+      double sum = z[i];
+      for(size_t p=diag[i]+1; p<rowptr[i+1]; ++p) {
+        sum -= lu[p] * z[colidx[p]];
+      }
+      z[i] = sum / lu[diag[i]];
+    }
+  }
+
+  //! out = A * v, using the raw CSR arrays
+  void csrProd(const UBSPMATRIX &A, const ublas::vector<double> &v, ublas::vector<double> &out)
+  {
+    const UBSPMATRIX::index_array_type &rowptr = A.index1_data();
+    const UBSPMATRIX::index_array_type &colidx = A.index2_data();
+    const UBSPMATRIX::value_array_type &val = A.value_data();
+    for(size_t i=0; i<A.size1(); ++i) {
+      double sum = 0.0;
+      for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+        sum += val[p] * v[colidx[p]];
+      }
+      out[i] = sum;
+    }
+  }
+}
+
+/*!
+ * Compute out = B^T * v.  This is the gradient of 0.5 * F.F when v = F.
+ * \param[in] B: the sparse Jacobian
+ * \param[in] v: the vector to multiply
+ * \param[out] out: the product.  Must already be sized.
+ */
+void sparseTransProd(const UBSPMATRIX &B, const ublas::vector<double> &v, ublas::vector<double> &out)
+{
+  const UBSPMATRIX::index_array_type &rowptr = B.index1_data();
+  const UBSPMATRIX::index_array_type &colidx = B.index2_data();
+  const UBSPMATRIX::value_array_type &val = B.value_data();
+  out.clear();
+  for(size_t i=0; i<B.size1(); ++i) {
+    for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+      out[colidx[p]] += val[p] * v[i];
+    }
+  }
+}
+
+/*!
+ * Sparse secant update of the Jacobian (Schubert's method).
+ * \details This is Broyden's update applied row-by-row, with the step
+ *          dx projected onto the sparsity pattern of each row.  The
+ *          updated matrix satisfies the secant condition B . dx = df
+ *          and keeps the pattern of B, so no fill-in is created.
+ *          Rows whose pattern has no overlap with dx are left alone.
+ * \param[in,out] B: the sparse Jacobian
+ * \param[in] dx: the step taken in x
+ * \param[in] df: the resulting change in F( x )
+ */
+void sparseBroydenUpdate(UBSPMATRIX &B, const ublas::vector<double> &dx, const ublas::vector<double> &df)
+{
+  const UBSPMATRIX::index_array_type &rowptr = B.index1_data();
+  const UBSPMATRIX::index_array_type &colidx = B.index2_data();
+  UBSPMATRIX::value_array_type &val = B.value_data();
+  for(size_t i=0; i<B.size1(); ++i) {
+    double bdx = 0.0;
+    double dx2 = 0.0;
+    for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+      double dxj = dx[colidx[p]];
+      bdx += val[p] * dxj;
+      dx2 += dxj * dxj;
+    }
+    if(dx2 > 0.0) {
+      double scale = (df[i] - bdx) / dx2;
+      for(size_t p=rowptr[i]; p<rowptr[i+1]; ++p) {
+        val[p] += scale * dx[colidx[p]];
+      }
+    }
+  }
+}
+
+/*!
+ * Solve A x = b using restarted GMRES with right ILU(0) preconditioning.
+ * \details x will replace b on output.  The iteration starts from x =
+ *          0 and stops when ||b - A x|| <= tol * ||b||.  If the
+ *          iteration does not converge the best iterate found is still
+ *          returned in b, since the line search can often make use of
+ *          an approximate Newton step.
+ * \param[in] A: the sparse Jacobian
+ * \param[in,out] b: the right hand side on input; the solution on output
+ * \param[in] tol: relative residual tolerance
+ * \param[in] restart: dimension of the Krylov subspace before a restart
+ * \param[in] maxiter: maximum total number of GMRES iterations
+ * \param[in] logf: stream for diagnostic output
+ * \return 0 on success, the (1-based) row with a zero pivot in the
+ *         preconditioner, or -1 if the iteration did not converge.
+ */
+int gmresSolve(const UBSPMATRIX &A, ublas::vector<double> &b, double tol, int restart, int maxiter,
+               std::ostream &logf)
+{
+  const size_t n = A.size1();
+  std::vector<double> lu;
+  std::vector<size_t> diag;
+  int sing = ilu0(A, lu, diag);
+  if(sing > 0) {
+    logf << "ILU(0) preconditioner has a zero pivot in row " << sing-1 << "\n";
+    return sing;
+  }
+
+  const double bnorm = ublas::norm_2(b);
+  ublas::vector<double> x(n);
+  x.clear();
+  if(bnorm == 0.0) {
+    b = x;
+    return 0;
+  }
+
+  const int m = restart < static_cast<int>(n) ? restart : static_cast<int>(n);
+  std::vector<ublas::vector<double> > V(m+1, ublas::vector<double>(n));
+  ublas::matrix<double> H(m+1, m);
+  ublas::vector<double> cs(m), sn(m), g(m+1);
+  ublas::vector<double> r(b), w(n), z(n);
+  double rnorm = bnorm;
+  int iter = 0;
+
+  while(iter < maxiter) {
+    V[0] = r / rnorm;
+    g.clear();
+    g[0] = rnorm;
+    H.clear();
+
+    int k = 0;
+    for(; k<m && iter<maxiter; ++k, ++iter) {
+      // w = A M^-1 v_k
+      z = V[k];
+      ilu0Solve(A, lu, diag, z);
+      csrProd(A, z, w);
+      // modified Gram-Schmidt
+      for(int j=0; j<=k; ++j) {
+        H(j,k) = ublas::inner_prod(w, V[j]);
+        w -= H(j,k) * V[j];
+      }
+      H(k+1,k) = ublas::norm_2(w);
+      if(H(k+1,k) > 0.0) {
+        V[k+1] = w / H(k+1,k);
+      }
+      // apply the previous rotations to the new column, then
+      // eliminate its subdiagonal entry
+      for(int j=0; j<k; ++j) {
+        double tmp = cs[j]*H(j,k) + sn[j]*H(j+1,k);
+        H(j+1,k) = -sn[j]*H(j,k) + cs[j]*H(j+1,k);
+        H(j,k) = tmp;
+      }
+      double denom = std::sqrt(H(k,k)*H(k,k) + H(k+1,k)*H(k+1,k));
+      if(denom == 0.0) {
+        // Krylov space is exhausted without progress; stop here.
+        break;
+      }
+      cs[k] = H(k,k) / denom;
+      sn[k] = H(k+1,k) / denom;
+      H(k,k) = denom;
+      H(k+1,k) = 0.0;
+      g[k+1] = -sn[k]*g[k];
+      g[k] = cs[k]*g[k];
+      if(std::fabs(g[k+1]) <= tol*bnorm) {
+        ++k;
+        ++iter;
+        break;
+      }
+    }
+
+    // back substitution for the subspace coefficients, then x += M^-1 V y
+    ublas::vector<double> y(k);
+    for(int i=k-1; i>=0; --i) {
+      double sum = g[i];
+      for(int j=i+1; j<k; ++j) {
+        sum -= H(i,j) * y[j];
+      }
+      y[i] = sum / H(i,i);
+    }
+    z.clear();
+    for(int j=0; j<k; ++j) {
+      z += y[j] * V[j];
+    }
+    ilu0Solve(A, lu, diag, z);
+    x += z;
+
+    csrProd(A, x, w);
+    r = b - w;
+    rnorm = ublas::norm_2(r);
+    if(rnorm <= tol*bnorm) {
+      b = x;
+      return 0;
+    }
+    if(k == 0) {
+      break;
+    }
+  }
+
+  logf << "GMRES did not converge after " << iter << " iterations.  ||r|| / ||b|| = "
+       << rnorm / bnorm << "\n";
+  b = x;
+  return -1;
+}
@@ -46,18 +46,17 @@
 
 namespace ublas = boost::numeric::ublas;
 
-// Solve U*S*VT * x = b,
-// Where U,S,VT are the SVD of a matrix.  x will replace b on output
-int svdInvertSolve(const ublas::matrix<double,ublas::column_major> &U,
-                     const ublas::vector<double> &S,
-                     const ublas::matrix<double,ublas::column_major> &VT,
-                     ublas::vector<double> &b,
-                     std::ostream &logf)
+// Form the (pseudo-)inverse of U*S*VT,
+// Where U,S,VT are the SVD of a matrix.  Ainv must already be sized.
+int svdInvert(const ublas::matrix<double,ublas::column_major> &U,
+              const ublas::vector<double> &S,
+              const ublas::matrix<double,ublas::column_major> &VT,
+              ublas::matrix<double,ublas::column_major> &Ainv,
+              std::ostream &logf)
 {
   const double small = 1.0e-8;
   int nsing = 0;
   ublas::matrix<double,ublas::column_major> Utmp(U.size2(),U.size1()), Vtmp(VT.size2(),VT.size1());
-  ublas::matrix<double,ublas::column_major> Ainv(Vtmp.size1(),Utmp.size2());
   ublas::vector<double> tmpvec(Vtmp.size2()); // able to store a row of VT (== a column of V)
   
 
@@ -118,6 +117,20 @@ int svdInvertSolve(const ublas::matrix<double,ublas::column_major> &U,
 
   Ainv = prod(Vtmp,Utmp);
 
+  return nsing;
+}
+
+// Solve U*S*VT * x = b,
+// Where U,S,VT are the SVD of a matrix.  x will replace b on output
+int svdInvertSolve(const ublas::matrix<double,ublas::column_major> &U,
+                     const ublas::vector<double> &S,
+                     const ublas::matrix<double,ublas::column_major> &VT,
+                     ublas::vector<double> &b,
+                     std::ostream &logf)
+{
+  ublas::matrix<double,ublas::column_major> Ainv(VT.size2(),U.size1());
+  int nsing = svdInvert(U,S,VT,Ainv,logf);
+
   ublas::vector<double> bb(b);
   axpy_prod(Ainv,bb,b);
 
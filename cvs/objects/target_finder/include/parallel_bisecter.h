@@ -0,0 +1,117 @@
+#ifndef _PARALLEL_BISECTER_H_
+#define _PARALLEL_BISECTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+ * \file parallel_bisecter.h
+ * \ingroup Objects
+ * \brief The ParallelBisecter class header file.
+ */
+
+#include <vector>
+#include <utility>
+
+/*!
+ * \brief Object which searches for a target by evaluating several trial values
+ *        at a time.
+ * \details Unlike the ITargetSolver implementations this object does not
+ *          query the target for the status of a trial directly. The statuses
+ *          of each set of trials are instead passed back to it since the trials
+ *          may have been evaluated in separate processes. Until the solution is
+ *          bracketed the trials grow geometrically from the highest value known
+ *          to be too low. Once bracketed, the bracket is split into evenly
+ *          spaced trials, one of which is replaced with the false position
+ *          estimate when the status at both bounds is known.
+ *
+ *          A status greater than zero indicates the trial value was too low and
+ *          a status less than zero that it was too high, as with the Bisecter.
+ */
+class ParallelBisecter {
+public:
+    ParallelBisecter( const double aTolerance,
+                      const double aMaximum,
+                      const double aInitialValue,
+                      const double aInitialStatus,
+                      const double aMultiple,
+                      const unsigned int aNumTrials );
+
+    std::pair<std::vector<double>, bool> getNextValues( const std::vector<double>& aStatuses );
+
+    unsigned int getIterations() const;
+
+    double getBestValue() const;
+private:
+    //! The tolerance of the target.
+    const double mTolerance;
+
+    //! The maximum trial value to use.
+    double mMaximum;
+
+    //! The growth in trial values while the solution is not yet bracketed.
+    const double mMultiple;
+
+    //! The number of trials to generate at a time.
+    const unsigned int mNumTrials;
+
+    //! The highest trial value which was too low.
+    double mLowerBound;
+
+    //! The status at the lower bound.
+    double mLowerStatus;
+
+    //! The lowest trial value which was too high, undefined until one is found.
+    double mUpperBound;
+
+    //! The status at the upper bound.
+    double mUpperStatus;
+
+    //! The trial value with the smallest absolute status seen so far.
+    std::pair<double, double> mBestTrial;
+
+    //! The trial values which were last returned.
+    std::vector<double> mCurrentTrials;
+
+    //! The number of sets of trial values returned.
+    unsigned int mIterations;
+
+    void updateBounds( const double aValue, const double aStatus );
+
+    void printState() const;
+};
+
+#endif // _PARALLEL_BISECTER_H_
@@ -103,6 +103,9 @@ class Modeltime;
  *                   (optional) The default is 2020.
  *              - \c max-iterations PolicyTargetRunner::mMaxIterations
  *                   (optional) The default is 100.
+ *              - \c trial-workers PolicyTargetRunner::mNumTrialWorkers
+ *                   (optional) The default is 1 which evaluates one trial tax
+ *                   at a time in this process.
  *              - \c stabilization PolicyTargetRunner::mInitialTargetYear
  *                   (optional) Set the initial target year to the flag
  *                   ITarget::getUseMaxTargetYearFlag(), this is the default.
@@ -181,6 +184,10 @@ private:
     //! ITarget::getUseMaxTargetYearFlag() if we are doing a stabilization.
     int mInitialTargetYear;
 
+    //! The number of trial taxes to evaluate at once in forked worker
+    //! processes when solving for the initial target.
+    unsigned int mNumTrialWorkers;
+
     //! Whether the target runner has already parsed its data. The XML parse
     //! can be called directly from the BatchRunner and in that case the object
     //! should not parse data from its separate configuration file.
@@ -211,6 +218,8 @@ private:
                                 std::vector<double>& aTaxes );
 
     void setTrialTaxes( const std::vector<double> aTaxes );
+
+    bool runTaxedPeriods();
     
     bool solveInitialTarget( std::vector<double>& aTaxes,
                              const ITarget* aPolicyTarget,
@@ -218,6 +227,22 @@ private:
                              const double aTolerance,
                              Timer& aTimer );
     
+    bool searchInitialTargetForked( std::vector<double>& aTaxes,
+                                    const ITarget* aPolicyTarget,
+                                    const unsigned int aLimitIterations,
+                                    const double aTolerance );
+
+    void evaluateTrialsForked( const std::vector<double>& aTrials,
+                               const std::vector<double>& aTaxes,
+                               const ITarget* aPolicyTarget,
+                               std::vector<double>& aStatuses );
+
+    double evaluateTrial( const double aTrial,
+                          const std::vector<double>& aTaxes,
+                          const ITarget* aPolicyTarget );
+    
+    bool isSolvedThroughTargetYear( const ITarget* aPolicyTarget );
+    
     bool solveFutureTarget( std::vector<double>& aTaxes,
                             const ITarget* aPolicyTarget,
                             const unsigned int aLimitIterations,
@@ -0,0 +1,231 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file parallel_bisecter.cpp
+ * \ingroup Objects
+ * \brief ParallelBisecter class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "util/logger/include/ilogger.h"
+#include "target_finder/include/parallel_bisecter.h"
+#include "target_finder/include/itarget_solver.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+/*!
+ * \brief Construct the ParallelBisecter.
+ * \param aTolerance Solution tolerance.
+ * \param aMaximum The maximum trial value.
+ * \param aInitialValue A trial value which has already been evaluated.
+ * \param aInitialStatus The status of the initial trial value.
+ * \param aMultiple Amount to grow trial values by until the solution is
+ *                  bracketed.
+ * \param aNumTrials The number of trial values to return at a time.
+ */
+ParallelBisecter::ParallelBisecter( const double aTolerance,
+                                    const double aMaximum,
+                                    const double aInitialValue,
+                                    const double aInitialStatus,
+                                    const double aMultiple,
+                                    const unsigned int aNumTrials ):
+mTolerance( aTolerance ),
+mMaximum( aMaximum ),
+mMultiple( aMultiple > 0 ? aMultiple : 1 ),
+mNumTrials( max( aNumTrials, 1u ) ),
+mLowerBound( 0 ),
+mLowerStatus( numeric_limits<double>::quiet_NaN() ),
+mUpperBound( ITargetSolver::undefined() ),
+mUpperStatus( numeric_limits<double>::quiet_NaN() ),
+mBestTrial( aInitialValue, aInitialStatus ),
+mIterations( 0 )
+{
+    updateBounds( aInitialValue, aInitialStatus );
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    targetLog << "Constructing a ParallelBisecter. Max: " << mMaximum
+              << " Number of trials: " << mNumTrials << " Initial trial: ("
+              << aInitialValue << ", " << aInitialStatus << ")" << endl;
+}
+
+/*!
+ * \brief Get the next set of trial values and check for solution.
+ * \details Updates the bracket with the statuses of the last set of trial
+ *          values and then returns the next set to evaluate. If the search is
+ *          finished the returned vector contains only the best trial value
+ *          found. This is also the case when the bracket or the maximum trial
+ *          value have been reached without meeting the tolerance which, as
+ *          with the Bisecter, is logged and then treated as solved.
+ * \param aStatuses The statuses of each of the trial values last returned, this
+ *                  should be empty on the first call.
+ * \return A pair of the next trial values to evaluate and whether the search
+ *         is finished.
+ */
+pair<vector<double>, bool> ParallelBisecter::getNextValues( const vector<double>& aStatuses ) {
+    assert( aStatuses.size() == mCurrentTrials.size() );
+    for( size_t i = 0; i < aStatuses.size(); ++i ) {
+        updateBounds( mCurrentTrials[ i ], aStatuses[ i ] );
+    }
+    ++mIterations;
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+
+    mCurrentTrials.clear();
+    bool isFinished = true;
+    if( fabs( mBestTrial.second ) < mTolerance ) {
+        targetLog << "Found solution. ";
+        mCurrentTrials.push_back( mBestTrial.first );
+    }
+    else if( mUpperBound != ITargetSolver::undefined() ) {
+        if( mUpperBound - mLowerBound < mTolerance ) {
+            targetLog << "Failed to solve because the bracket width is empty. ";
+            mCurrentTrials.push_back( mBestTrial.first );
+        }
+        else {
+            // Split the bracket into evenly spaced trials.
+            isFinished = false;
+            const double width = mUpperBound - mLowerBound;
+            for( unsigned int i = 1; i <= mNumTrials; ++i ) {
+                mCurrentTrials.push_back( mLowerBound + width * i / ( mNumTrials + 1 ) );
+            }
+
+            // Use the false position estimate in place of the closest trial
+            // when the status at both bounds is known.
+            if( !std::isnan( mLowerStatus ) && !std::isnan( mUpperStatus ) ) {
+                const double estimate = mLowerBound - mLowerStatus * width
+                    / ( mUpperStatus - mLowerStatus );
+                const double position = ( estimate - mLowerBound ) / width * ( mNumTrials + 1 );
+                const unsigned int closest = static_cast<unsigned int>(
+                    min( max( position - 0.5, 0.0 ), static_cast<double>( mNumTrials - 1 ) ) );
+                mCurrentTrials[ closest ] = estimate;
+            }
+        }
+    }
+    else if( mLowerBound >= mMaximum - mTolerance ) {
+        targetLog << "Failed to solve because the upper bound was reached. ";
+        mCurrentTrials.push_back( mBestTrial.first );
+    }
+    else {
+        // The solution is not yet bracketed so grow the trials from the lower
+        // bound until the maximum is reached.
+        isFinished = false;
+        double trial = mLowerBound > 0 ? mLowerBound : 1;
+        for( unsigned int i = 0; i < mNumTrials; ++i ) {
+            trial = min( trial * ( 1 + mMultiple ), mMaximum );
+            mCurrentTrials.push_back( trial );
+            if( trial >= mMaximum ) {
+                break;
+            }
+        }
+    }
+
+    if( !isFinished ) {
+        targetLog << "Attempting to solve target. Iteration: " << mIterations << " ";
+    }
+    printState();
+
+    return make_pair( mCurrentTrials, isFinished );
+}
+
+/*!
+ * \brief Update the bracket and best trial with the status of a trial value.
+ * \details A trial with an invalid status, which occurs when the climate model
+ *          could not be run, limits the maximum trial value instead.
+ * \param aValue The trial value.
+ * \param aStatus The status of the trial value.
+ */
+void ParallelBisecter::updateBounds( const double aValue, const double aStatus ) {
+    if( !util::isValidNumber( aStatus ) ) {
+        if( aValue > mLowerBound ) {
+            mMaximum = min( mMaximum, aValue );
+        }
+        return;
+    }
+
+    if( fabs( aStatus ) < fabs( mBestTrial.second ) || !util::isValidNumber( mBestTrial.second ) ) {
+        mBestTrial = make_pair( aValue, aStatus );
+    }
+
+    if( aStatus > 0 ) {
+        if( aValue >= mLowerBound ) {
+            mLowerBound = aValue;
+            mLowerStatus = aStatus;
+        }
+    }
+    else if( mUpperBound == ITargetSolver::undefined() || aValue < mUpperBound ) {
+        mUpperBound = aValue;
+        mUpperStatus = aStatus;
+    }
+}
+
+/*!
+ * \brief Print the current state of the search.
+ */
+void ParallelBisecter::printState() const {
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    targetLog << "The best trial is (" << mBestTrial.first << ", " << mBestTrial.second
+              << "). Lower bound is " << mLowerBound << " and upper bound is "
+              << mUpperBound << ". Next trials:";
+    for( size_t i = 0; i < mCurrentTrials.size(); ++i ) {
+        targetLog << " " << mCurrentTrials[ i ];
+    }
+    targetLog << endl;
+}
+
+/*!
+ * \brief Get the number of sets of trial values returned.
+ * \return The current number of iterations performed.
+ */
+unsigned int ParallelBisecter::getIterations() const {
+    return mIterations;
+}
+
+/*!
+ * \brief Get the evaluated trial value with the smallest absolute status.
+ * \details This is the value to use if the search was stopped before it
+ *          finished since the trial values last returned have not been
+ *          evaluated.
+ * \return The best trial value evaluated so far.
+ */
+double ParallelBisecter::getBestValue() const {
+    return mBestTrial.first;
+}
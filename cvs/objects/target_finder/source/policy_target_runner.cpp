@@ -61,6 +61,8 @@
 #include "policy/include/policy_ghg.h"
 #include "util/base/include/util.h"
 #include "marketplace/include/marketplace.h"
+#include "target_finder/include/parallel_bisecter.h"
+#include "util/base/include/forked_workers.h"
 
 using namespace std;
 using namespace xercesc;
@@ -72,6 +74,7 @@ PolicyTargetRunner::PolicyTargetRunner():
 mInitialTaxGuess( 5 ),
 mFirstTaxYear( 2020 ),
 mMaxIterations( 100 ),
+mNumTrialWorkers( 1 ),
 mInitialTargetYear( ITarget::getUseMaxTargetYearFlag() ),
 mHasParsedConfig( false ),
 mRunID( 0 ),
@@ -135,6 +138,9 @@ bool PolicyTargetRunner::XMLParse( const xercesc::DOMNode* aRoot ){
         else if ( nodeName == "max-iterations" ){
             mMaxIterations = XMLHelper<unsigned int>::getValue( curr );
         }
+        else if ( nodeName == "trial-workers" ){
+            mNumTrialWorkers = XMLHelper<unsigned int>::getValue( curr );
+        }
         else if( nodeName == "stabilization" ) {
             mInitialTargetYear = ITarget::getUseMaxTargetYearFlag();
         }
@@ -406,10 +412,9 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     const int finalModelYear = getInternalScenario()->getModeltime()->getEndYear();
 
     // Run the model without a tax target once to get a baseline for the
-    // solver and to calculate the initial non-tax periods.
+    // solver. The initial non-tax periods were calculated by the baseline run.
     logRunID();
-    bool success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS,
-                                                  false, aTimer );
+    bool success = runTaxedPeriods();
     
     // If we are already below the target at a zero tax then we won't be able to
     // get to the target.
@@ -419,6 +424,16 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
         return false;
     }
 
+    if( mNumTrialWorkers > 1 ) {
+        if( ForkedWorkers::isEnabled() ) {
+            // Evaluate several trial taxes at once in separate processes.
+            return searchInitialTargetForked( aTaxes, aPolicyTarget, aLimitIterations, aTolerance );
+        }
+        targetLog.setLevel( ILogger::WARNING );
+        targetLog << "Trial workers are not supported in this build, evaluating one trial at a time."
+                  << endl;
+    }
+
     // Create the solver object for determining the initial tax rate that will meet the target
     // in the current trail target year. Use 0 as the initial trial tax value because the
     // state of the model is unknown. Probably need to use this since there is no way
@@ -467,7 +482,7 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
         // Run the scenario at the trial tax.
         // TODO: If the run failed to solve then the target status may be unreliable.
         logRunID();
-        success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS, false, aTimer );
+        success = runTaxedPeriods();
 
         targetLog << "Scenario run complete.  Return status = " << success << endl;
     }
@@ -482,20 +497,7 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
         // This is the case that we found the target however the run in which we
         // found the target had periods that did not solve.  If only periods after
         // target year did not solve then we will allow it.
-        success = true;
-        const vector<int>& unsolvedPeriods = mSingleScenario->getInternalScenario()->getUnsolvedPeriods();
-        const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
-        const int targetYear = mInitialTargetYear == ITarget::getUseMaxTargetYearFlag() ?
-            aPolicyTarget->getYearOfMaxTargetValue() : mInitialTargetYear;
-        for( vector<int>::const_iterator it = unsolvedPeriods.begin();
-             it != unsolvedPeriods.end() && success; ++it )
-        {
-            if( targetYear >= modeltime->getper_to_yr( *it ) ) {
-                targetLog.setLevel( ILogger::ERROR );
-                targetLog << "Failed due to unsolved model period: " << *it << endl;
-                success = false;
-            }
-        }
+        success = isSolvedThroughTargetYear( aPolicyTarget );
     }
         
     if( success ) {
@@ -506,6 +508,176 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     return success;
 }
 
+/*!
+ * \brief Check that no period up to the target year failed to solve in the
+ *        last run.
+ * \details Unsolved periods after the target year are allowed since they do
+ *          not affect whether the target was found.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \return Whether all periods up to the target year solved.
+ */
+bool PolicyTargetRunner::isSolvedThroughTargetYear( const ITarget* aPolicyTarget ) {
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    const vector<int>& unsolvedPeriods = mSingleScenario->getInternalScenario()->getUnsolvedPeriods();
+    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
+    const int targetYear = mInitialTargetYear == ITarget::getUseMaxTargetYearFlag() ?
+        aPolicyTarget->getYearOfMaxTargetValue() : mInitialTargetYear;
+    for( vector<int>::const_iterator it = unsolvedPeriods.begin(); it != unsolvedPeriods.end(); ++it ) {
+        if( targetYear >= modeltime->getper_to_yr( *it ) ) {
+            targetLog.setLevel( ILogger::ERROR );
+            targetLog << "Failed due to unsolved model period: " << *it << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Search for the initial target evaluating several trial taxes at once.
+ * \details Each set of trial initial taxes generated by a ParallelBisecter is
+ *          evaluated concurrently in forked copies of this process. Once the
+ *          search is finished the final trial is run again in this process so
+ *          that the scenario holds its results.
+ * \param aTaxes The vector to store the taxes in.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \param aLimitIterations The maximum number of sets of trials to evaluate.
+ * \param aTolerance The tolerance of the solution.
+ * \return Whether the target was met successfully.
+ */
+bool PolicyTargetRunner::searchInitialTargetForked( vector<double>& aTaxes,
+                                                    const ITarget* aPolicyTarget,
+                                                    const unsigned int aLimitIterations,
+                                                    const double aTolerance )
+{
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    const int firstTaxPeriod = getInternalScenario()->getModeltime()->getyr_to_per( mFirstTaxYear );
+
+    // The model has been run at the initial tax which gives the first point in
+    // the search.
+    ParallelBisecter solver( aTolerance,
+                             mMaxTax,
+                             aTaxes[ firstTaxPeriod ],
+                             aPolicyTarget->getStatus( mInitialTargetYear ),
+                             mInitialTaxGuess - 1,
+                             mNumTrialWorkers );
+
+    vector<double> statuses;
+    pair<vector<double>, bool> trials = solver.getNextValues( statuses );
+    while( !trials.second && solver.getIterations() < aLimitIterations ) {
+        targetLog.setLevel( ILogger::NOTICE );
+        targetLog << "Iteration " << solver.getIterations() << " evaluating "
+                  << trials.first.size() << " trial values." << endl;
+
+        evaluateTrialsForked( trials.first, aTaxes, aPolicyTarget, statuses );
+        trials = solver.getNextValues( statuses );
+    }
+
+    // Run the final trial in this process.  If the iteration limit was reached
+    // the last trials were never evaluated so use the best one that was.
+    const double finalTrial = trials.second ? trials.first.front() : solver.getBestValue();
+    calculateHotellingPath( finalTrial,
+                            mPathDiscountRate,
+                            getInternalScenario()->getModeltime(),
+                            mFirstTaxYear,
+                            getInternalScenario()->getModeltime()->getEndYear(),
+                            aTaxes );
+    setTrialTaxes( aTaxes );
+    logRunID();
+    bool success = runTaxedPeriods();
+
+    targetLog.setLevel( ILogger::NOTICE );
+    targetLog << "Scenario run complete.  Return status = " << success << endl;
+
+    if( !trials.second ){
+        targetLog.setLevel( ILogger::ERROR );
+        targetLog << "Exiting target finding search as the iterations limit was"
+                  << " reached." << endl;
+        return false;
+    }
+    if( !success ) {
+        success = isSolvedThroughTargetYear( aPolicyTarget );
+    }
+    if( success ) {
+        targetLog.setLevel( ILogger::NOTICE );
+        targetLog << "Target value was found by search algorithm in "
+                  << solver.getIterations() << " iterations." << endl;
+    }
+    return success;
+}
+
+/*!
+ * \brief Evaluate the status of the target for a set of trial initial taxes.
+ * \details Each trial is run in a forked worker which starts from a copy of the
+ *          current state of the model, so the model is only parsed and the
+ *          untaxed periods are only solved once.
+ * \param aTrials The trial initial taxes to evaluate.
+ * \param aTaxes The current tax vector which gives the taxes before the first
+ *        tax year.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \param aStatuses The vector to store the status of each trial in.
+ */
+void PolicyTargetRunner::evaluateTrialsForked( const vector<double>& aTrials,
+                                               const vector<double>& aTaxes,
+                                               const ITarget* aPolicyTarget,
+                                               vector<double>& aStatuses )
+{
+    vector<ForkedWorkers::Task> tasks;
+    for( size_t i = 0; i < aTrials.size(); ++i ) {
+        const double trial = aTrials[ i ];
+        tasks.push_back( [this, trial, &aTaxes, aPolicyTarget]() {
+            return vector<double>( 1, evaluateTrial( trial, aTaxes, aPolicyTarget ) );
+        } );
+    }
+    const vector<vector<double> > results = ForkedWorkers::run( tasks, mNumTrialWorkers );
+
+    // A worker which exited without a result says nothing about the trial so
+    // rather than letting it move the bracket evaluate it again in this process.
+    aStatuses.clear();
+    for( size_t i = 0; i < results.size(); ++i ) {
+        if( results[ i ].empty() ) {
+            ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+            targetLog.setLevel( ILogger::WARNING );
+            targetLog << "Worker evaluating trial " << aTrials[ i ]
+                      << " did not return a result, evaluating it again." << endl;
+            aStatuses.push_back( evaluateTrial( aTrials[ i ], aTaxes, aPolicyTarget ) );
+        }
+        else {
+            aStatuses.push_back( results[ i ][ 0 ] );
+        }
+    }
+}
+
+/*!
+ * \brief Run the scenario at a trial initial tax and get the target status.
+ * \param aTrial The trial initial tax.
+ * \param aTaxes The current tax vector which gives the taxes before the first
+ *        tax year.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \return The status of the target in the initial target year.
+ */
+double PolicyTargetRunner::evaluateTrial( const double aTrial,
+                                          const vector<double>& aTaxes,
+                                          const ITarget* aPolicyTarget )
+{
+    vector<double> taxes( aTaxes );
+    calculateHotellingPath( aTrial,
+                            mPathDiscountRate,
+                            getInternalScenario()->getModeltime(),
+                            mFirstTaxYear,
+                            getInternalScenario()->getModeltime()->getEndYear(),
+                            taxes );
+    setTrialTaxes( taxes );
+
+    // TODO: If the run failed to solve then the target status may be unreliable.
+    logRunID();
+    runTaxedPeriods();
+    return aPolicyTarget->getStatus( mInitialTargetYear );
+}
+
 /*!
  * \brief Solve a target for a year past the target year.
  * \details For years past the target year the tax must be modified such that
@@ -819,6 +991,23 @@ void PolicyTargetRunner::setTrialTaxes( const vector<double> aTaxes ) {
     mSingleScenario->getInternalScenario()->setTax( &tax );
 }
 
+/*!
+ * \brief Run the scenario for the first tax period and all periods after it.
+ * \details The periods before the first tax year are not affected by the trial
+ *          taxes so the results already calculated for them are kept and only
+ *          the taxed periods are solved again.
+ * \return Whether all model periods are solved successfully.
+ */
+bool PolicyTargetRunner::runTaxedPeriods() {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Starting a model run. Running from year " << mFirstTaxYear << "." << endl;
+
+    Scenario* scenario = mSingleScenario->getInternalScenario();
+    const int firstTaxPeriod = scenario->getModeltime()->getyr_to_per( mFirstTaxYear );
+    return scenario->runFromPeriod( firstTaxPeriod, false, scenario->getName() );
+}
+
 /*!
  * \brief Write a unique identifier into each of several log files
  */
@@ -45,6 +45,8 @@
  * \author Pralit Patel
  */
 
+#include <vector>
+#include <map>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
@@ -157,9 +159,11 @@ public:
      */
     virtual const ITechnology* getNewVintageTechnology( const int aPeriod ) const = 0;
     
-    // Typedef some iterators to abstract away syntax
-    typedef std::map<int, ITechnology*>::const_reverse_iterator CTechRangeIterator;
-    typedef std::map<int, ITechnology*>::reverse_iterator TechRangeIterator;
+    // Typedef some iterators to abstract away syntax.  Vintages are iterated
+    // over a contiguous year sorted array so that walking the operating
+    // vintages is a linear scan rather than a tree traversal.
+    typedef std::vector<std::pair<int, ITechnology*> >::const_reverse_iterator CTechRangeIterator;
+    typedef std::vector<std::pair<int, ITechnology*> >::reverse_iterator TechRangeIterator;
     
     /*!
      * \brief Get an iterator which can be used to iterate over all potentially
@@ -46,6 +46,7 @@
  */
 
 #include <map>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include "technologies/include/itechnology_container.h"
 
@@ -179,17 +180,22 @@ private:
     // Some typedefs to make using interpolation rules more readable.
     typedef std::vector<InterpolationRule*>::const_iterator CInterpRuleIterator;
     
+    //! A flat copy of mVintages sorted by year which is built in completeInit.
+    //! The vintage range iterators walk this array so that iterating over the
+    //! operating vintages touches contiguous memory.
+    std::vector<std::pair<int, ITechnology*> > mVintageArray;
+    
+    //! The index into mVintageArray of the most recent vintage which may be
+    //! operating in each model period or -1 if there is none.
+    objects::PeriodVector<int> mVintageBeginIndex;
+    
     //! The period which has been cached to optimize finding and iterating over
     //! the operating technologies in that period.
     int mCachedVintageRangePeriod;
 
-    //! The cached begin iterator returned in getVintageBegin if the period matches
-    //! mCachedVintageRangePeriod.
-    TechRangeIterator mCachedTechRangeBegin;
-
-    //! The cached begin iterator returned in getVintageEnd if the period matches
-    //! mCachedVintageRangePeriod.
-    TechRangeIterator mCachedTechRangeEnd;
+    //! The index into mVintageArray of the last vintage which is still operating
+    //! in mCachedVintageRangePeriod, the range ends just beyond it.
+    int mCachedVintageEndIndex;
     
     bool createAndParseVintage( const xercesc::DOMNode* aNode, const std::string& aTechType );
     
@@ -198,6 +204,8 @@ private:
     void clearInterpolationRules();
     
     void interpolateVintage( const int aYear, CVintageIterator aPrevTech, CVintageIterator aNextTech );
+    
+    void buildVintageArray();
 };
 
 #endif // _TECHNOLOGY_CONTAINER_H_
@@ -43,6 +43,7 @@
 #include "containers/include/scenario.h"
 #include "util/base/include/model_time.h"
 #include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
 
 
 
@@ -101,9 +102,8 @@ void RESSecondaryOutput::setPhysicalOutput( const double aPrimaryOutput,
     // because the sector which has this output as a primary will attempt to
     // fill all of demand. If this technology also added to supply, supply would
     // not equal demand.
-    Marketplace* marketplace = scenario->getMarketplace();
-    marketplace->addToSupply( mName, mMarketName.empty() ? aRegionName : mMarketName,
-                              mPhysicalOutputs[ aPeriod ], aPeriod, true );
+    mCachedMarket->addToSupply( mName, mMarketName.empty() ? aRegionName : mMarketName,
+                                mPhysicalOutputs[ aPeriod ], aPeriod, true );
 
 }
 
@@ -91,6 +91,7 @@
 #include "marketplace/include/marketplace.h"
 
 #include "util/base/include/initialize_tech_vector_helper.hpp"
+#include "util/base/include/manage_state_variables.hpp"
 
 using namespace std;
 using namespace xercesc;
@@ -1473,6 +1474,8 @@ void Technology::copyGHGParameters( const AGHG* prevGHG ) {
     }
     if( !found ) {
         mGHG.push_back( prevGHG->clone() );
+        // The new GHG has state of its own which will need to be found.
+        ManageStateVariables::clearLayoutCache();
     }
 }
 
@@ -40,6 +40,7 @@
 #include "util/base/include/definitions.h"
 #include <string>
 #include <cassert>
+#include <algorithm>
 #include <xercesc/dom/DOMNodeList.hpp>
 
 #include "util/base/include/util.h"
@@ -73,6 +74,7 @@ TechnologyContainer::TechnologyContainer()
     mInitialAvailableYear = -1;
     mFinalAvailableYear = -1;
     mCachedVintageRangePeriod = -1;
+    mCachedVintageEndIndex = -1;
 }
 
 //! Destructor
@@ -81,6 +83,7 @@ TechnologyContainer::~TechnologyContainer() {
         delete ( *vintageIt ).second;
     }
     mVintages.clear();
+    mVintageArray.clear();
     
     // just in case null out the period vector as well
     for( int period = 0; period < mVintagesByPeriod.size(); ++period ) {
@@ -382,6 +385,46 @@ void TechnologyContainer::completeInit( const string& aRegionName,
         ( *vintageIt ).second->completeInit( aRegionName, aSectorName, aSubsectorName,
                                              aSubsecInfo, aLandAllocator );
     }
+    
+    // The set of vintages is now final so flatten them for iteration.
+    buildVintageArray();
+}
+
+/*!
+ * \brief Copy the vintages into the contiguous mVintageArray and compute, for
+ *        each model period, the index of the most recent vintage that could be
+ *        operating in that period.
+ * \details The map remains the primary container for parsing and introspection
+ *          while the array is what the range iterators walk during calc.  This
+ *          must be called any time mVintages changes after completeInit.
+ */
+void TechnologyContainer::buildVintageArray() {
+    mVintageArray.assign( mVintages.begin(), mVintages.end() );
+    mCachedVintageRangePeriod = -1;
+    mCachedVintageEndIndex = -1;
+    
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( int period = 0; period < mVintageBeginIndex.size(); ++period ) {
+        const int year = modeltime->getper_to_yr( period );
+        
+        // Lower bound will give us the first technology which is not < year so we
+        // must then make sure that it is not > year.  If all vintages are before
+        // year then the last vintage is the most recent one.
+        vector<pair<int, ITechnology*> >::const_iterator vintageIter =
+            lower_bound( mVintageArray.begin(), mVintageArray.end(), year,
+                         []( const pair<int, ITechnology*>& aVintage, const int aYear ) {
+                             return aVintage.first < aYear;
+                         } );
+        if( vintageIter == mVintageArray.end() ) {
+            mVintageBeginIndex[ period ] = static_cast<int>( mVintageArray.size() ) - 1;
+        }
+        else if( ( *vintageIter ).first > year ) {
+            mVintageBeginIndex[ period ] = -1;
+        }
+        else {
+            mVintageBeginIndex[ period ] = static_cast<int>( vintageIter - mVintageArray.begin() );
+        }
+    }
 }
 
 void TechnologyContainer::initCalc( const string& aRegionName, const string& aSectorName,
@@ -411,9 +454,9 @@ void TechnologyContainer::initCalc( const string& aRegionName, const string& aSe
     // Currently calls initCalc on all vintages past and future.
     // TODO: Should not call initialization for all future technology vintages beyond the
     // current period but correction causing error (SHK).
-    for( VintageIterator vintageIt = mVintages.begin(); vintageIt != mVintages.end(); ++vintageIt ) {
-        ( *vintageIt ).second->initCalc( aRegionName, aSectorName, aSubsecInfo, aDemographic,
-                                         prevPeriodInfo, aPeriod );
+    for( size_t i = 0; i < mVintageArray.size(); ++i ) {
+        mVintageArray[ i ].second->initCalc( aRegionName, aSectorName, aSubsecInfo, aDemographic,
+                                             prevPeriodInfo, aPeriod );
         prevPeriodInfo.mIsFirstTech = false;
     }
     
@@ -423,28 +466,22 @@ void TechnologyContainer::initCalc( const string& aRegionName, const string& aSe
     // Cache the first and last technologies to those that are operating in this period
     // to avoid iterating over more technologies than necessary.  We must be careful to
     // check all past vintages in case the operating technologies are not contiguous.
+    // Since the range is walked from the most recent vintage backwards the end is
+    // the oldest vintage that is still operating, everything before it is skipped.
     mCachedVintageRangePeriod = -1;
-    mCachedTechRangeBegin = getVintageBegin( aPeriod );
-    mCachedTechRangeEnd = mVintages.rend();
-    for( TechRangeIterator it = mCachedTechRangeBegin; it != mVintages.rend(); ++it ) {
-        if( mCachedTechRangeEnd != mVintages.rend() && (*it).second->isOperating( aPeriod ) ) {
-            // We found a vintage that is still operating so we must reset the end
-            // iterator and keep looking for an earlier end point.
-            mCachedTechRangeEnd = mVintages.rend();
-        }
-        else if( mCachedTechRangeEnd == mVintages.rend() && !(*it).second->isOperating( aPeriod ) ) {
-            // We have found a vintage that is no longer operating.  This could
-            // potentially be our end iterator provided we don't find and earlier
-            // vintage that is still operating.
-            mCachedTechRangeEnd = it;
+    mCachedVintageEndIndex = 0;
+    for( int i = 0; i <= mVintageBeginIndex[ aPeriod ]; ++i ) {
+        if( mVintageArray[ i ].second->isOperating( aPeriod ) ) {
+            break;
         }
+        mCachedVintageEndIndex = i + 1;
     }
     mCachedVintageRangePeriod = aPeriod;
 }
 
 void TechnologyContainer::postCalc( const string& aRegionName, const int aPeriod ) {
-    for( VintageIterator vintageIt = mVintages.begin(); vintageIt != mVintages.end(); ++vintageIt ) {
-        ( *vintageIt ).second->postCalc( aRegionName, aPeriod );
+    for( size_t i = 0; i < mVintageArray.size(); ++i ) {
+        mVintageArray[ i ].second->postCalc( aRegionName, aPeriod );
     }
 }
 
@@ -457,65 +494,25 @@ const ITechnology* TechnologyContainer::getNewVintageTechnology( const int aPeri
 }
 
 ITechnologyContainer::TechRangeIterator TechnologyContainer::getVintageBegin( const int aPeriod ) {
-    // If the given period matches the cached period then we can use the cached
-    // begin iterator and avoid having to find it.
-    if( aPeriod == mCachedVintageRangePeriod ) {
-        return mCachedTechRangeBegin;
-    }
-    const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
-    
-    // Lower bound will give us the first technology which is not < year so we must
-    // then make sure that it is not > year and is not beyond the final investment
-    // year.  In those cases decrease the iterator to make sure we don't go include
-    // a technology beyond aPeriod.
-    VintageIterator vintageIter = mVintages.lower_bound( year );
-    if( vintageIter == mVintages.end() ) {
-        --vintageIter;
-    }
-    else if( ( *vintageIter ).first > year ) {
-        return mVintages.rend();
-    }
-    
-    // Converting a forward iterator to a reverse in not completely intuitive.  We
-    // need to decrease one from the converted forward iterator to be in the same place.
-    return --TechRangeIterator( vintageIter );
+    // A reverse iterator constructed from a forward position refers to the element
+    // just before it so add one to the index.  An index of -1 gives rend.
+    return TechRangeIterator( mVintageArray.begin() + ( mVintageBeginIndex[ aPeriod ] + 1 ) );
 }
 
 ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageBegin( const int aPeriod ) const {
-    // If the given period matches the cached period then we can use the cached
-    // begin iterator and avoid having to find it.
-    if( aPeriod == mCachedVintageRangePeriod ) {
-        return mCachedTechRangeBegin;
-    }
-    const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
-    
-    // Lower bound will give us the first technology which is not < year so we must
-    // then make sure that it is not > year and is not beyond the final investment
-    // year.  In those cases decrease the iterator to make sure we don't go include
-    // a technology beyond aPeriod.
-    CVintageIterator vintageIter = mVintages.lower_bound( year );
-    if( vintageIter == mVintages.end() ) {
-        --vintageIter;
-    }
-    else if( ( *vintageIter ).first > year ) {
-        return mVintages.rend();
-    }
-    
-    // Converting a forward iterator to a reverse in not completely intuitive.  We
-    // need to decrease one from the converted forward iterator to be in the same place.
-    return --CTechRangeIterator( vintageIter );
+    return CTechRangeIterator( mVintageArray.begin() + ( mVintageBeginIndex[ aPeriod ] + 1 ) );
 }
 
 ITechnologyContainer::TechRangeIterator TechnologyContainer::getVintageEnd( const int aPeriod ) {
     // If the given period matches the cached period then we can use the cached
-    // end iterator and avoid iterating over unnecessary technologies.
-    return aPeriod == mCachedVintageRangePeriod ? mCachedTechRangeEnd : mVintages.rend();
+    // end index and avoid iterating over unnecessary technologies.
+    return aPeriod == mCachedVintageRangePeriod ?
+        TechRangeIterator( mVintageArray.begin() + mCachedVintageEndIndex ) : mVintageArray.rend();
 }
 
 ITechnologyContainer::CTechRangeIterator TechnologyContainer::getVintageEnd( const int aPeriod ) const {
-    // If the given period matches the cached period then we can use the cached
-    // end iterator and avoid iterating over unnecessary technologies.
-    return aPeriod == mCachedVintageRangePeriod ? static_cast<CTechRangeIterator>( mCachedTechRangeEnd ) : mVintages.rend();
+    return aPeriod == mCachedVintageRangePeriod ?
+        CTechRangeIterator( mVintageArray.begin() + mCachedVintageEndIndex ) : mVintageArray.rend();
 }
 
 /*!
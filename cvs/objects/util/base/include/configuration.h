@@ -84,6 +84,7 @@ public:
 	int getInt( const std::string& key, const int defaultValue = 0, const bool mustExist = true ) const;
 	double getDouble( const std::string& key, const double defaultValue = 0, const bool mustExist = true ) const;
     const std::list<std::string>& getScenarioComponents() const;
+    void disableFileOutput();
 private:
     const std::string mLogFile; //!< The name of the log to use.
     static std::auto_ptr<Configuration> gInstance; //!< The static instance of the Configuration class.
@@ -93,6 +94,8 @@ private:
     //! Map file names to a flag if set indicates that the scenario name should be post-pended
     //! to the file name when written.
 	std::map<std::string, bool> mShouldAppendScnFileMap;
+    //! Flag which if set indicates that no file should be written regardless of mShouldWriteFileMap.
+    bool mFileOutputDisabled;
 	std::map<std::string, std::string> stringMap; //!< A map of the strings the program uses.
 	std::map<std::string, bool> boolMap; //!< A map of the bools the program uses.
 	std::map<std::string, int> intMap;  //!< A map of the ints the program uses.
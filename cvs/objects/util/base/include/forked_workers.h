@@ -0,0 +1,97 @@
+#ifndef _FORKED_WORKERS_H_
+#define _FORKED_WORKERS_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file forked_workers.h  
+* \ingroup Objects
+* \brief Header file for the ForkedWorkers class.
+*/
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+/*!
+* \ingroup Objects
+* \brief Runs independent model evaluations concurrently in forked copies of
+*        the process.
+* \details Scenario runners which need the results of several runs of the same
+*          scenario that differ only in a few inputs, such as a trial tax, can
+*          not run them concurrently in a single process as the model state is
+*          shared.  Forking a copy of the process for each run instead gives
+*          each task its own copy-on-write copy of the already parsed, and
+*          possibly partially solved, model.  Each task returns a vector of
+*          values, or a block of text, which is sent back to the parent
+*          through a pipe.  The model state of the parent is left unchanged
+*          by tasks run in a worker.  Each worker writes its logs to its own
+*          files so that they are not mixed into those of the parent.
+*
+*          Forking is only supported on POSIX systems and is not used when
+*          GCAM_PARALLEL_ENABLED as the TBB scheduler does not survive a fork.
+*          When it is not supported, or a worker can not be forked, the tasks
+*          are run in this process one at a time in which case they do change
+*          the model state.
+*/
+class ForkedWorkers {
+public:
+    //! A task to run in a worker which returns the values to report back.
+    typedef std::function<std::vector<double>()> Task;
+
+    //! A task to run in a worker which returns text to report back.
+    typedef std::function<std::string()> TextTask;
+
+    static bool isEnabled();
+
+    static std::vector<std::vector<double> > run( const std::vector<Task>& aTasks,
+                                                  const unsigned int aMaxWorkers );
+
+    static std::vector<std::string> runText( const std::vector<TextTask>& aTasks,
+                                             const unsigned int aMaxWorkers );
+private:
+    static std::vector<std::string> runTasks( const std::vector<TextTask>& aTasks,
+                                              const unsigned int aMaxWorkers,
+                                              const bool aWriteFiles );
+
+    static bool readFully( const int aFD, void* aBuffer, const size_t aSize );
+
+    static bool writeFully( const int aFD, const void* aBuffer, const size_t aSize );
+};
+
+#endif // _FORKED_WORKERS_H_
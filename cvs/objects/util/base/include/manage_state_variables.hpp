@@ -44,11 +44,15 @@
  */
 
 #include <cassert>
-#include <forward_list>
+#include <memory>
 #include <string>
+#include <vector>
+#include <cstdint>
 #include "util/base/include/definitions.h"
 
 class Value;
+class ITechnology;
+class Market;
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/task_arena.h>
@@ -67,6 +71,14 @@ class Value;
  *          developers do not need to worry about any of this.  All they have to do
  *          is ensure they appropriately tag their STATE Data.
  *
+ *          The GCAMFusion search is relatively expensive so the location of all
+ *          STATE Data, active or not, is cached the first time it is run and reused
+ *          in later periods.  Only which Data is active needs to be re-evaluated for
+ *          each period.  The cache must be cleared by calling clearLayoutCache
+ *          whenever objects containing STATE Data are added or removed, including
+ *          during initCalc such as when a Technology copies forward a GHG from
+ *          the previous vintage.
+ *
  * \author Pralit Patel
  */
 class ManageStateVariables {
@@ -78,6 +90,8 @@ public:
     
     void setPartialDeriv( const bool aIsPartialDeriv );
     
+    static void clearLayoutCache();
+    
 #if GCAM_PARALLEL_ENABLED
     //! A tbb task arena which is the closest tbb comes to a thread pool which we
     //! will insist parallel calculations use so that we can ensure that we have
@@ -112,19 +126,89 @@ private:
     //! be changed during World.calc( mPeriodToCollect ).
     size_t mNumCollected;
     
+    //! The number of blocks of state values which are tracked as dirty.  Each
+    //! block covers 2^Value::STATE_BLOCK_SHIFT state values so that copyState
+    //! only needs to restore the blocks a partial derivative actually changed.
+    size_t mNumBlocks;
+    
     //! The list of individual Values flagged as STATE that could possibly be
     //! changed during World.calc( mPeriodToCollect ).  We store them in a list
-    //! since searching via GCAMFusion is a relatively expensive operation and we
-    //! will need to take three passes at them:
+    //! since we will need to take three passes at them:
     //! - Figure out how many we have so what we can allocate enough memory for mStateData.
     //! - Copy the actual data from each Value to initialize the "base" state.
     //! - When we are done with this period copy the "base" state back into each Value.
-    std::forward_list<Value*> mStateValues;
+    std::vector<Value*> mStateValues;
+    
+    //! A hash of the GCAMFusion path to each Value in mStateValues, in the same
+    //! order.  These are written to restart files so that state may be matched
+    //! by path when warm starting from a structurally similar scenario.
+    std::vector<uint64_t> mStatePathHashes;
+    
+    //! A fingerprint of the layout of the collected state computed from each of
+    //! the mStatePathHashes which is used to check a restart file was generated
+    //! from the same scenario structure.
+    uint64_t mLayoutHash;
+    
+    /*!
+     * \brief A single Data flagged as STATE found by GCAMFusion along with what
+     *        is needed to decide if it is active in a given period.
+     */
+    struct StateSite {
+        //! The type of Data which determines which Values in it are active.
+        enum SiteType {
+            eValue,
+            ePeriodVector,
+            eTechVintageVector,
+            eYearVector
+        };
+        
+        //! The type of mData.
+        SiteType mType;
+        
+        //! The Data itself which should be cast back according to mType.
+        void* mData;
+        
+        //! The Technology which contains this Data if any.  The Data is only
+        //! active in periods in which the Technology is operating.
+        const ITechnology* mTechnology;
+        
+        //! The Market which contains this Data if any.  The Data is only active
+        //! in the year of the Market.
+        const Market* mMarket;
+        
+        //! The index into StateLayout::mContainerPathHashes of the container
+        //! this Data was found in.
+        size_t mContainer;
+    };
+    
+    /*!
+     * \brief The location of all Data flagged as STATE in the order GCAMFusion
+     *        found them.
+     */
+    struct StateLayout {
+        //! Every Data flagged as STATE regardless of whether it is active.
+        std::vector<StateSite> mSites;
+        
+        //! The hash of the path to each container that has a StateSite in it.
+        std::vector<uint64_t> mContainerPathHashes;
+    };
+    
+    //! The cached layout of all STATE Data which is reused until clearLayoutCache
+    //! is called.
+    static std::unique_ptr<StateLayout> sLayoutCache;
     
     void collectState();
     
+    static void collectLayout( StateLayout& aLayout );
+    
+    bool isSiteActive( const StateSite& aSite ) const;
+    
+    void addStateValue( Value* aValue, const size_t aContainer, std::vector<size_t>& aNumValuesByContainer );
+    
     void resetState();
     
+    unsigned char* getDirtyFlags( double* aState ) const;
+    
     std::string getRestartFileName() const;
     
     void loadRestartFile();
@@ -136,19 +220,44 @@ private:
      *        for data flagged STATE.
      * \details In addition to handling the processData call back we also are
      *          interested in the push/pop filter steps, particularly for Technology
-     *          and MarketContainer to avoid collecting Data in a Technology or
-     *          Market that is going to be inactive during mPeriodToCollect.
+     *          and MarketContainer so that Data in a Technology or Market can later
+     *          be checked to see if it is going to be inactive in a given period.
      */
     struct DoCollect {
-        //! A reference to the containing class where each collected state data
-        //! will be added.
-        ManageStateVariables* mParentClass;
+        //! The layout where each STATE Data found will be added.
+        StateLayout* mLayout;
+        
+        //! The Technology currently being searched if any.  This gets reset when
+        //! the corresponding popFilterStep is found.
+        const ITechnology* mCurrTechnology = 0;
+        
+        //! The Market currently being searched if any.  This gets reset when
+        //! the corresponding popFilterStep is found.
+        const Market* mCurrMarket = 0;
+        
+        /*!
+         * \brief The hash of the path to a container that is currently being
+         *        searched as well as counters to identify unnamed children in it.
+         */
+        struct PathFrame {
+            //! The hash of the path from the Scenario to this container.
+            uint64_t mHash;
+            
+            //! The number of child containers stepped into so far.
+            size_t mNumChildren;
+            
+            //! The index into StateLayout::mContainerPathHashes for this container
+            //! or -1 if no STATE Data has been found directly in it yet.
+            int mContainer;
+        };
+        
+        //! The stack of containers from the Scenario to the one currently being
+        //! searched, updated as GCAMFusion pushes and pops filter steps.
+        std::vector<PathFrame> mPathStack;
+        
+        void pushPath( const uint64_t aKey );
         
-        //! A state variable while processing GCAMFusion which when set indicates
-        //! we are in a Technology or MarketContainer that is inactive in the
-        //! current period.  This flag gets reset when the corresponding popFilterStep
-        //! is found.
-        bool mIgnoreCurrValue = false;
+        void addSite( const StateSite::SiteType aType, void* aData );
         
         // Templated callbacks for GCAMFusion
         template<typename DataType>
@@ -105,7 +105,7 @@ protected:
 
     void printCSV( std::ostream& aOut, Scenario* aScenario, const int aPeriod, bool aPrintHeader );
 
-    int getMarketIndex(const std::string& aMarketName, std::vector<SolutionInfo> &aSolvable );
+    int getMarketIndex(const std::string& aMarketName, const std::vector<SolutionInfo> &aSolvable );
 
 };
 
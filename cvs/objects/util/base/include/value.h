@@ -138,6 +138,12 @@ private:
     //! A static reference into the "base" state of ManageStateVariables::mStateData
     //! mostly for convenience.
     static double* sBaseCentralValue;
+    //! The number of state values in each slot of ManageStateVariables::mStateData.
+    //! Each slot is followed by one dirty flag per block of state values which
+    //! gets set any time a value in that block is written.
+    static size_t sNumStateValues;
+    //! Log base 2 of the number of state values covered by a single dirty flag.
+    static const unsigned int STATE_BLOCK_SHIFT = 6;
     //! The index into sCentralValue that contains the data for this instance.
     unsigned int mCentralValueIndex;
     //! A flag to indicate if this instance of Value has been identified as active
@@ -180,17 +186,24 @@ inline void Value::init( const double aNewValue ){
 /*!
  * \brief An accessor method to get at the actual data held in this class.
  * \details This method will appropriately get the value locally or the centrally
- *          managed state if the mIsStateCopy flag is set.
+ *          managed state if the mIsStateCopy flag is set.  Centrally managed
+ *          state is marked as dirty since the caller intends to modify it.
  * \return A reference the the appropriate value represented by this class.
  */
 inline double& Value::getInternal() {
-    return mIsStateCopy ?
+    if( mIsStateCopy ) {
 #if !GCAM_PARALLEL_ENABLED
-        sCentralValue[mCentralValueIndex]
+        double* state = sCentralValue;
 #else
-        sCentralValue.local()[mCentralValueIndex]
+        double* state = sCentralValue.local();
 #endif
-        : mValue;
+        // This accessor is only used to modify the value so flag its block
+        // as changed, allowing ManageStateVariables::copyState to restore only
+        // the blocks that have actually been written.
+        reinterpret_cast<unsigned char*>( state + sNumStateValues )[ mCentralValueIndex >> STATE_BLOCK_SHIFT ] = 1;
+        return state[ mCentralValueIndex ];
+    }
+    return mValue;
 }
 
 /*!
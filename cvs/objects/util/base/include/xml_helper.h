@@ -69,10 +69,13 @@
 #include <cassert>
 #include <vector>
 #include <map>
+#include <set>
 #include <memory>
 #include <typeinfo>
 
 #include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/parsers/SAXParser.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMAttr.hpp>
 #include <xercesc/dom/DOMElement.hpp>
@@ -81,8 +84,15 @@
 #include <xercesc/dom/DOMNodeList.hpp>
 #include <xercesc/dom/DOMImplementation.hpp>
 #include <xercesc/sax/HandlerBase.hpp>
+#include <xercesc/sax/AttributeList.hpp>
+#include <xercesc/util/XMLString.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/task_arena.h>
+#endif
+
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/trim.hpp>
 
@@ -103,6 +113,7 @@
 #include "util/base/include/iparsable.h"
 #include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
+#include "util/base/include/xml_parse_cache.h"
 
 /*!
  * \ingroup Objects
@@ -192,6 +203,9 @@ public:
 
    static int getNodePeriod ( const xercesc::DOMNode* node, const Modeltime* modeltime );
    static bool parseXML( const std::string& aXMLFile, IParsable* aModelElement );
+   static bool parseXMLStreaming( const std::string& aXMLFile, IParsable* aModelElement,
+                                  const std::set<std::string>& aSplitElements );
+   static bool parseXMLFiles( const std::list<std::string>& aXMLFiles, IParsable* aModelElement );
    static const std::string& text();
    static const std::string& name();
    static void cleanupParser();
@@ -205,6 +219,9 @@ private:
     static xercesc::DOMDocument** getDOMDocumentInternal();
     static void initParser();
     static xercesc::XercesDOMParser* getParser();
+    static xercesc::DOMDocument* parseDocument( const std::string& aXMLFile );
+    template<class ParserType>
+    static bool runParser( ParserType& aParser, const std::string& aXMLFile );
 };
 
 /*!
@@ -1026,11 +1043,219 @@ void XMLWriteVector( const objects::PeriodVector<T>& aOutputVector,
     }
 }
 
+/*!
+ * \brief A SAX document handler which streams a document to an IParsable in
+ *        pieces rather than first building the DOM for the entire document.
+ * \details Elements whose names are in the set of split elements along with the
+ *          root element make up the "spine" of the document and are not stored.
+ *          The subtree of each child of a spine element which is not itself a
+ *          split element is built as a DOM, along with empty copies of its spine
+ *          ancestors including their attributes, and handed to XMLParse as soon
+ *          as it is complete after which the DOM is released.  This is the same as
+ *          if each such subtree had been read from a separate add-on file which
+ *          relies on the split elements being containers that may be parsed
+ *          multiple times, such as the world and regions.  Thus only one subtree
+ *          needs to be held in memory at a time.  Note the delete attribute of a
+ *          spine element is only passed along the first time it is dispatched.
+ */
+class XMLStreamingHandler : public xercesc::HandlerBase {
+public:
+    XMLStreamingHandler( IParsable* aModelElement, const std::string& aXMLFile,
+                         const std::set<std::string>& aSplitElements )
+    :mModelElement( aModelElement ),
+    mXMLFile( aXMLFile ),
+    mSplitElements( aSplitElements ),
+    mDocument( 0 ),
+    mSuccess( true )
+    {
+    }
+    
+    ~XMLStreamingHandler() {
+        if( mDocument ) {
+            mDocument->release();
+        }
+    }
+    
+    //! Whether each call to XMLParse was successful.
+    bool isSuccessful() const {
+        return mSuccess;
+    }
+    
+    virtual void startElement( const XMLCh* const aName, xercesc::AttributeList& aAttrs ) {
+        if( mOpenElements.empty() || ( mOpenElements.back().mIsSpine &&
+            mSplitElements.find( XMLHelper<std::string>::safeTranscode( aName ) ) != mSplitElements.end() ) )
+        {
+            OpenElement spine;
+            spine.mIsSpine = true;
+            spine.mIsDispatched = false;
+            spine.mElement = 0;
+            spine.mName = copyString( aName );
+            for( XMLSize_t attrInd = 0; attrInd < aAttrs.getLength(); ++attrInd ) {
+                spine.mAttrs.push_back( std::make_pair( copyString( aAttrs.getName( attrInd ) ),
+                                                        copyString( aAttrs.getValue( attrInd ) ) ) );
+            }
+            mOpenElements.push_back( spine );
+            return;
+        }
+        
+        xercesc::DOMElement* parent;
+        if( mOpenElements.back().mIsSpine ) {
+            // Starting a new subtree to dispatch.
+            parent = createSpine();
+        }
+        else {
+            flushText();
+            parent = mOpenElements.back().mElement;
+        }
+        OpenElement curr;
+        curr.mIsSpine = false;
+        curr.mIsDispatched = false;
+        curr.mElement = mDocument->createElement( aName );
+        for( XMLSize_t attrInd = 0; attrInd < aAttrs.getLength(); ++attrInd ) {
+            curr.mElement->setAttribute( aAttrs.getName( attrInd ), aAttrs.getValue( attrInd ) );
+        }
+        parent->appendChild( curr.mElement );
+        mOpenElements.push_back( curr );
+    }
+    
+    virtual void characters( const XMLCh* const aChars, const XMLSize_t aLength ) {
+        // Text directly in a spine element is not kept.
+        if( !mOpenElements.empty() && !mOpenElements.back().mIsSpine ) {
+            mText.insert( mText.end(), aChars, aChars + aLength );
+        }
+    }
+    
+    virtual void endElement( const XMLCh* const aName ) {
+        if( mOpenElements.back().mIsSpine ) {
+            // A spine element which had no children to dispatch still needs to
+            // be dispatched on its own, for instance to create an empty region.
+            if( !mOpenElements.back().mIsDispatched ) {
+                createSpine();
+                dispatch();
+            }
+            mOpenElements.pop_back();
+        }
+        else {
+            flushText();
+            mOpenElements.pop_back();
+            if( mOpenElements.back().mIsSpine ) {
+                dispatch();
+            }
+        }
+    }
+    
+private:
+    //! An element which has been started but not yet ended.
+    struct OpenElement {
+        //! Whether this element is in the spine.
+        bool mIsSpine;
+        
+        //! Whether this spine element has been dispatched with any subtree.
+        bool mIsDispatched;
+        
+        //! The DOM element for an element which is not in the spine.
+        xercesc::DOMElement* mElement;
+        
+        //! The name of a spine element.
+        std::vector<XMLCh> mName;
+        
+        //! The attribute names and values of a spine element.
+        std::vector<std::pair<std::vector<XMLCh>, std::vector<XMLCh> > > mAttrs;
+    };
+    
+    //! The object to dispatch each subtree to.
+    IParsable* mModelElement;
+    
+    //! The name of the file being parsed.
+    const std::string mXMLFile;
+    
+    //! The names of the elements which make up the spine.
+    const std::set<std::string>& mSplitElements;
+    
+    //! The stack of open elements.
+    std::vector<OpenElement> mOpenElements;
+    
+    //! The document of the subtree currently being built.
+    xercesc::DOMDocument* mDocument;
+    
+    //! Text which has been read but not yet added to the current element.
+    std::vector<XMLCh> mText;
+    
+    //! Whether each call to XMLParse was successful.
+    bool mSuccess;
+    
+    static std::vector<XMLCh> copyString( const XMLCh* aString ) {
+        return std::vector<XMLCh>( aString, aString + xercesc::XMLString::stringLen( aString ) + 1 );
+    }
+    
+    /*!
+     * \brief Add any text read to the current element as a single text node.
+     */
+    void flushText() {
+        if( !mText.empty() ) {
+            mText.push_back( 0 );
+            mOpenElements.back().mElement->appendChild( mDocument->createTextNode( &mText[ 0 ] ) );
+            mText.clear();
+        }
+    }
+    
+    /*!
+     * \brief Create a new document which contains a copy of each open spine element.
+     * \return The innermost spine element.
+     */
+    xercesc::DOMElement* createSpine() {
+        mDocument = xercesc::DOMImplementation::getImplementation()->createDocument();
+        XMLCh* documentURI = xercesc::XMLString::transcode( mXMLFile.c_str() );
+        mDocument->setDocumentURI( documentURI );
+        xercesc::XMLString::release( &documentURI );
+        
+        xercesc::DOMNode* parent = mDocument;
+        for( auto& spine : mOpenElements ) {
+            if( !spine.mIsSpine ) {
+                break;
+            }
+            xercesc::DOMElement* curr = mDocument->createElement( &spine.mName[ 0 ] );
+            for( auto& attr : spine.mAttrs ) {
+                curr->setAttribute( &attr.first[ 0 ], &attr.second[ 0 ] );
+            }
+            parent->appendChild( curr );
+            parent = curr;
+        }
+        return static_cast<xercesc::DOMElement*>( parent );
+    }
+    
+    /*!
+     * \brief Pass the document that has been built to the model element and then
+     *        release it.
+     */
+    void dispatch() {
+        mSuccess &= mModelElement->XMLParse( mDocument->getDocumentElement() );
+        mDocument->release();
+        mDocument = 0;
+        
+        // Make sure deletes only happen once.
+        static const XMLCh DELETE_ATTR[] = { 'd', 'e', 'l', 'e', 't', 'e', 0 };
+        for( auto& spine : mOpenElements ) {
+            if( spine.mIsSpine ) {
+                spine.mIsDispatched = true;
+                for( auto attrIter = spine.mAttrs.begin(); attrIter != spine.mAttrs.end(); ++attrIter ) {
+                    if( xercesc::XMLString::equals( &(*attrIter).first[ 0 ], DELETE_ATTR ) ) {
+                        spine.mAttrs.erase( attrIter );
+                        break;
+                    }
+                }
+            }
+        }
+    }
+};
+
 /*!
 * \brief Function to parse an XML file, returning a pointer to the root.
 *
 * This is a very simple function which calls the parse function and handles the exceptions which it may throw.
-* It also takes care of fetching the document and its root element.
+* It also takes care of fetching the document and its root element.  If the
+* XMLParseCache is enabled the document is loaded from the cache when possible
+* and otherwise saved to it once parsed.
 * \param aXMLFile The name of the file to parse.
 * \param aModelElement Element to call XMLParse on.
 * \return Whether parsing was successful.
@@ -1041,27 +1266,28 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
     // Track the number of active parses to avoid destroying a document that causes other
     // documents to be parsed before its own parsing was complete.
     static unsigned int numParses = 0;
+    
+    // Skip parsing entirely if a pre-parsed version of this file is available.
+    const bool useCache = XMLParseCache::isEnabled();
+    if( useCache ) {
+        xercesc::DOMDocument* cachedDocument = XMLParseCache::loadDocument( aXMLFile );
+        if( cachedDocument ) {
+            bool success = aModelElement->XMLParse( cachedDocument->getDocumentElement() );
+            cachedDocument->release();
+            return success;
+        }
+    }
+    
     ++numParses;
     xercesc::XercesDOMParser* parser = XMLHelper<T>::getParser();
-    try {
-        parser->parse( aXMLFile.c_str() );
-    } catch ( const xercesc::XMLException& toCatch ) {
-        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
-        std::cout << "ERROR: XML Read Exception message is:" << std::endl << message << std::endl;
-        return false;
-    } catch ( const xercesc::DOMException& toCatch ) {
-        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.msg );
-        std::cout << "ERROR: XML Read Exception message is:" << std::endl << message << std::endl;
-        return false;
-    } catch ( const xercesc::SAXException& toCatch ){
-        std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
-        std::cout << "ERROR: XML Read Exception message is:" << std::endl << message << std::endl;
-        return false;
-    } catch (...) {
-        std::cout << "ERROR:Unexpected XML Read Exception." << std::endl;
+    if( !runParser( *parser, aXMLFile ) ) {
         return false;
     }
 
+    if( useCache ) {
+        XMLParseCache::saveDocument( aXMLFile, parser->getDocument() );
+    }
+    
     bool success = aModelElement->XMLParse( parser->getDocument()->getDocumentElement() );
     // Cleanup parser memory if there are no active parses.
     if( --numParses == 0 ){
@@ -1071,6 +1297,159 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
     return success;
 }
 
+/*!
+* \brief Function to parse an XML file without building the DOM for the entire
+*        document at once.
+* \details The file is read with a SAX parser and each subtree under the elements
+*          named in aSplitElements is passed to aModelElement as soon as it has
+*          been read.  See XMLStreamingHandler for details.  This substantially
+*          reduces the memory required to parse large files.  If the XMLParseCache
+*          is enabled this simply calls parseXML since the cache requires the
+*          full document.
+* \param aXMLFile The name of the file to parse.
+* \param aModelElement Element to call XMLParse on.
+* \param aSplitElements The names of the elements which may be split.
+* \return Whether parsing was successful.
+*/
+template <class T>
+bool XMLHelper<T>::parseXMLStreaming( const std::string& aXMLFile, IParsable* aModelElement,
+                                      const std::set<std::string>& aSplitElements )
+{
+    if( XMLParseCache::isEnabled() ) {
+        return parseXML( aXMLFile, aModelElement );
+    }
+    
+    // Ensure the XML platform has been initialized.
+    XMLHelper<T>::getParser();
+    
+    xercesc::SAXParser parser;
+    parser.setValidationScheme( xercesc::SAXParser::Val_Always );
+    parser.setDoNamespaces( false );
+    parser.setDoSchema( true );
+    XMLStreamingHandler handler( aModelElement, aXMLFile, aSplitElements );
+    parser.setDocumentHandler( &handler );
+    parser.setErrorHandler( &handler );
+    if( !runParser( parser, aXMLFile ) ) {
+        return false;
+    }
+    return handler.isSuccessful();
+}
+
+/*!
+* \brief Function to parse a list of XML files, in order, into the same element.
+* \details When GCAM_PARALLEL_ENABLED the files are read into DOM documents
+*          concurrently, each with its own parser, in batches as large as the
+*          number of threads available.  The documents of each batch are then
+*          passed to XMLParse in the order the files were given so that the
+*          result is the same as parsing the files one after the other, including
+*          when later files override data in earlier ones.  Batching bounds the
+*          number of documents held in memory at once.  If the XMLParseCache is
+*          enabled the files are parsed one at a time as loading from the cache
+*          is already quick.
+* \param aXMLFiles The names of the files to parse in the order to apply them.
+* \param aModelElement Element to call XMLParse on.
+* \return Whether parsing was successful.
+*/
+template <class T>
+bool XMLHelper<T>::parseXMLFiles( const std::list<std::string>& aXMLFiles, IParsable* aModelElement ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if GCAM_PARALLEL_ENABLED
+    if( !XMLParseCache::isEnabled() ) {
+        // Ensure the XML platform has been initialized.
+        XMLHelper<T>::getParser();
+        
+        const std::vector<std::string> xmlFiles( aXMLFiles.begin(), aXMLFiles.end() );
+        const size_t batchSize = std::max( tbb::this_task_arena::max_concurrency(), 1 );
+        std::vector<xercesc::DOMDocument*> documents( batchSize, 0 );
+        bool success = true;
+        for( size_t batchStart = 0; batchStart < xmlFiles.size() && success; batchStart += batchSize ) {
+            const size_t batchEnd = std::min( batchStart + batchSize, xmlFiles.size() );
+            tbb::task_group parseGroup;
+            for( size_t fileIndex = batchStart; fileIndex < batchEnd; ++fileIndex ) {
+                parseGroup.run( [&xmlFiles, &documents, batchStart, fileIndex] () {
+                    documents[ fileIndex - batchStart ] = parseDocument( xmlFiles[ fileIndex ] );
+                } );
+            }
+            parseGroup.wait();
+            
+            for( size_t fileIndex = batchStart; fileIndex < batchEnd; ++fileIndex ) {
+                xercesc::DOMDocument*& currDocument = documents[ fileIndex - batchStart ];
+                if( success ) {
+                    mainLog.setLevel( ILogger::NOTICE );
+                    mainLog << "Parsing " << xmlFiles[ fileIndex ] << " scenario component." << std::endl;
+                    success = currDocument && aModelElement->XMLParse( currDocument->getDocumentElement() );
+                }
+                if( currDocument ) {
+                    currDocument->release();
+                    currDocument = 0;
+                }
+            }
+        }
+        return success;
+    }
+#endif
+    for( auto currFile = aXMLFiles.begin(); currFile != aXMLFiles.end(); ++currFile ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Parsing " << *currFile << " scenario component." << std::endl;
+        if( !parseXML( *currFile, aModelElement ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+* \brief Parse an XML file into a new DOM document using a parser dedicated to
+*        this call so that files may be parsed concurrently.
+* \param aXMLFile The name of the file to parse.
+* \return The parsed document which the caller must release, or null if the
+*         file could not be parsed.
+*/
+template <class T>
+xercesc::DOMDocument* XMLHelper<T>::parseDocument( const std::string& aXMLFile ) {
+    xercesc::XercesDOMParser parser;
+    xercesc::HandlerBase errorHandler;
+    parser.setValidationScheme( xercesc::XercesDOMParser::Val_Always );
+    parser.setDoNamespaces( false );
+    parser.setDoSchema( true );
+    parser.setCreateCommentNodes( false ); // No comment nodes
+    parser.setIncludeIgnorableWhitespace( false ); // No text nodes
+    parser.setErrorHandler( &errorHandler );
+    if( !runParser( parser, aXMLFile ) ) {
+        return 0;
+    }
+    // Take ownership of the document so that it outlives the parser.
+    return parser.adoptDocument();
+}
+
+/*!
+* \brief Run the given parser on a file and report any exception it throws.
+* \param aParser The parser to run which may be either a DOM or SAX parser.
+* \param aXMLFile The name of the file to parse.
+* \return Whether the parser ran without throwing an exception.
+*/
+template <class T>
+template <class ParserType>
+bool XMLHelper<T>::runParser( ParserType& aParser, const std::string& aXMLFile ) {
+    std::string message;
+    try {
+        aParser.parse( aXMLFile.c_str() );
+        return true;
+    } catch ( const xercesc::XMLException& toCatch ) {
+        message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
+    } catch ( const xercesc::DOMException& toCatch ) {
+        message = XMLHelper<std::string>::safeTranscode( toCatch.msg );
+    } catch ( const xercesc::SAXException& toCatch ){
+        message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
+    } catch (...) {
+        message = "Unexpected exception.";
+    }
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::ERROR );
+    mainLog << "XML Read Exception while parsing " << aXMLFile << ":" << std::endl << message << std::endl;
+    return false;
+}
+
 /*! \brief Function which initializes the XML Platform and creates an instance
 * of an error handler and parser.
 * \note Logs are not initialized yet so they cannot be used.
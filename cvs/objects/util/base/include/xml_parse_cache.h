@@ -0,0 +1,77 @@
+#ifndef _XML_PARSE_CACHE_H_
+#define _XML_PARSE_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file xml_parse_cache.h  
+* \ingroup Objects
+* \brief Header file for the XMLParseCache class.
+*/
+
+#include <string>
+#include <xercesc/dom/DOMDocument.hpp>
+
+/*!
+* \ingroup Objects
+* \brief A cache of pre-parsed XML input files stored in a compact binary form.
+* \details Parsing the model input through Xerces, which includes scanning,
+*          transcoding and validating against the schema, is a significant
+*          part of the startup time of a run.  When the xml-input-cache file is
+*          set in the configuration each DOM document parsed by XMLHelper is
+*          saved to a binary file in that directory which is keyed by the hash
+*          of the contents of the input file.  Subsequent runs which parse an
+*          input file with the same contents can then rebuild the DOM directly
+*          from the binary file, which holds the strings already transcoded,
+*          skipping the parser entirely.  A change to an input file changes its
+*          hash and so it will simply get parsed and cached again.
+*/
+class XMLParseCache {
+public:
+    static bool isEnabled();
+    
+    static xercesc::DOMDocument* loadDocument( const std::string& aXMLFile );
+    
+    static void saveDocument( const std::string& aXMLFile, const xercesc::DOMDocument* aDocument );
+
+private:
+    static std::string getCacheFileName( const std::string& aXMLFile );
+    
+    static void createCacheDirectory( const std::string& aCacheFileName );
+};
+
+#endif // _XML_PARSE_CACHE_H_
@@ -56,7 +56,7 @@ using namespace xercesc;
 std::auto_ptr<Configuration> Configuration::gInstance;
 
 //! Private constructor to prevent a programmer from creating a second object.
-Configuration::Configuration(): mLogFile( "main_log" ){
+Configuration::Configuration(): mLogFile( "main_log" ), mFileOutputDisabled( false ){
 }
 
 /*! \brief Get a pointer to the instance of the Configuration object.
@@ -228,6 +228,9 @@ const string& Configuration::getFile( const string& key, const string& defaultVa
  * \return Returns the value found in the map for the specified key, or if none is found the default value.
  */
 bool Configuration::shouldWriteFile( const string& aKey, const bool aDefaultValue, const bool aMustExist ) const {
+    if( mFileOutputDisabled ) {
+        return false;
+    }
     map<string,bool>::const_iterator found = mShouldWriteFileMap.find( aKey );
     if ( found != mShouldWriteFileMap.end() ) {
         return found->second;
@@ -398,3 +401,12 @@ double Configuration::getDouble( const string& key, const double defaultValue, c
 const list<string>& Configuration::getScenarioComponents() const {
     return scenarioComponents;
 }
+
+/*!
+* \brief Turn off writing of all files such that shouldWriteFile always returns false.
+* \details This is used by forked workers whose runs are only used for the values
+*          they report back so that they do not overwrite the files of the parent.
+*/
+void Configuration::disableFileOutput() {
+    mFileOutputDisabled = true;
+}
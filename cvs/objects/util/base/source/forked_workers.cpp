@@ -0,0 +1,264 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file forked_workers.cpp
+* \ingroup Objects
+* \brief ForkedWorkers class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#include <algorithm>
+#include <stdint.h>
+#include "util/base/include/forked_workers.h"
+#include "util/logger/include/ilogger.h"
+#include "util/logger/include/logger_factory.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+
+#if !defined( _MSC_VER ) && !GCAM_PARALLEL_ENABLED
+#define FORKED_WORKERS_ENABLED 1
+#include <unistd.h>
+#include <sys/wait.h>
+#else
+#define FORKED_WORKERS_ENABLED 0
+#endif
+
+using namespace std;
+
+/*!
+ * \brief Whether tasks can be run in forked workers in this build.
+ * \return True if tasks will be run in forked workers.
+ */
+bool ForkedWorkers::isEnabled() {
+    return FORKED_WORKERS_ENABLED;
+}
+
+/*!
+ * \brief Run a set of tasks, at most aMaxWorkers at a time.
+ * \details Each task is run in a forked worker when possible and otherwise in
+ *          this process once the workers have finished.  A task whose worker
+ *          exited without reporting its values, for instance because it
+ *          crashed, gets an empty vector of values.  Only the values are kept
+ *          from a task run in a worker so workers do not write any files other
+ *          than their own logs.
+ * \param aTasks The tasks to run.
+ * \param aMaxWorkers The maximum number of workers to run at once.
+ * \return The values returned by each task in the same order as the tasks.
+ */
+vector<vector<double> > ForkedWorkers::run( const vector<Task>& aTasks,
+                                            const unsigned int aMaxWorkers )
+{
+    // The values are sent back as their raw bytes.
+    vector<TextTask> textTasks;
+    textTasks.reserve( aTasks.size() );
+    for( size_t i = 0; i < aTasks.size(); ++i ) {
+        const Task& task = aTasks[ i ];
+        textTasks.push_back( [&task]() {
+            const vector<double> values = task();
+            return values.empty() ? string() :
+                string( reinterpret_cast<const char*>( &values[ 0 ] ), values.size() * sizeof( double ) );
+        } );
+    }
+    const vector<string> textResults = runTasks( textTasks, aMaxWorkers, false );
+
+    vector<vector<double> > results( aTasks.size() );
+    for( size_t i = 0; i < textResults.size(); ++i ) {
+        results[ i ].resize( textResults[ i ].size() / sizeof( double ) );
+        if( !results[ i ].empty() ) {
+            copy( textResults[ i ].begin(), textResults[ i ].begin() + results[ i ].size() * sizeof( double ),
+                  reinterpret_cast<char*>( &results[ i ][ 0 ] ) );
+        }
+    }
+    return results;
+}
+
+/*!
+ * \brief Run a set of tasks which report text, at most aMaxWorkers at a time.
+ * \details Each task is run in a forked worker when possible and otherwise in
+ *          this process once the workers have finished.  A task whose worker
+ *          exited without reporting its text, for instance because it crashed,
+ *          gets an empty string.  Workers write files as configured so the
+ *          caller must ensure that the files written by each task do not
+ *          collide.
+ * \param aTasks The tasks to run.
+ * \param aMaxWorkers The maximum number of workers to run at once.
+ * \return The text returned by each task in the same order as the tasks.
+ */
+vector<string> ForkedWorkers::runText( const vector<TextTask>& aTasks,
+                                       const unsigned int aMaxWorkers )
+{
+    return runTasks( aTasks, aMaxWorkers, true );
+}
+
+/*!
+ * \brief Run a set of tasks which report text in forked workers.
+ * \details Each worker writes its logs to its own files, named by the index of
+ *          its task, so that they are not mixed into the logs of this process.
+ * \param aTasks The tasks to run.
+ * \param aMaxWorkers The maximum number of workers to run at once.
+ * \param aWriteFiles Whether workers should write the files set in the
+ *        Configuration.
+ * \return The text returned by each task in the same order as the tasks.
+ */
+vector<string> ForkedWorkers::runTasks( const vector<TextTask>& aTasks,
+                                        const unsigned int aMaxWorkers,
+                                        const bool aWriteFiles )
+{
+    vector<string> results( aTasks.size() );
+    vector<bool> wasForked( aTasks.size(), false );
+#if FORKED_WORKERS_ENABLED
+    const size_t batchSize = max( aMaxWorkers, 1u );
+    for( size_t batchStart = 0; batchStart < aTasks.size(); batchStart += batchSize ) {
+        const size_t batchEnd = min( batchStart + batchSize, aTasks.size() );
+        vector<pid_t> workers( batchEnd - batchStart, -1 );
+        vector<int> resultPipes( batchEnd - batchStart, -1 );
+        for( size_t i = batchStart; i < batchEnd; ++i ) {
+            int fds[ 2 ];
+            if( pipe( fds ) != 0 ) {
+                continue;
+            }
+            // Make sure buffered output is not written again by the worker.
+            cout.flush();
+            cerr.flush();
+            LoggerFactory::flushAll();
+            const pid_t pid = fork();
+            if( pid == 0 ) {
+                // In the worker run the task and report the text.  Exit without
+                // running any destructors or cleanup which belong to the parent.
+                close( fds[ 0 ] );
+                LoggerFactory::redirectAll( "-worker" + util::toString( i ) );
+                if( !aWriteFiles ) {
+                    Configuration::getInstance()->disableFileOutput();
+                }
+                const string text = aTasks[ i ]();
+                cout.flush();
+                LoggerFactory::flushAll();
+                const uint64_t numBytes = text.size();
+                const bool wroteText = writeFully( fds[ 1 ], &numBytes, sizeof( numBytes ) ) &&
+                    ( text.empty() || writeFully( fds[ 1 ], text.data(), text.size() ) );
+                _exit( wroteText ? 0 : 1 );
+            }
+            close( fds[ 1 ] );
+            if( pid > 0 ) {
+                workers[ i - batchStart ] = pid;
+                resultPipes[ i - batchStart ] = fds[ 0 ];
+                wasForked[ i ] = true;
+            }
+            else {
+                close( fds[ 0 ] );
+            }
+        }
+
+        // Collect the text from each worker in order.  Workers which are not
+        // yet being read from will block once the pipe is full which is fine
+        // as they are done with the model by then.
+        for( size_t i = batchStart; i < batchEnd; ++i ) {
+            if( !wasForked[ i ] ) {
+                continue;
+            }
+            const int fd = resultPipes[ i - batchStart ];
+            uint64_t numBytes = 0;
+            if( readFully( fd, &numBytes, sizeof( numBytes ) ) ) {
+                string text( numBytes, '\0' );
+                if( numBytes == 0 || readFully( fd, &text[ 0 ], numBytes ) ) {
+                    results[ i ].swap( text );
+                }
+            }
+            close( fd );
+            waitpid( workers[ i - batchStart ], 0, 0 );
+        }
+    }
+#endif
+
+    // Run any tasks which could not be run in a worker in this process.
+    for( size_t i = 0; i < aTasks.size(); ++i ) {
+        if( !wasForked[ i ] ) {
+            if( FORKED_WORKERS_ENABLED ) {
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::WARNING );
+                mainLog << "Could not fork a worker, running task " << i << " in this process." << endl;
+            }
+            results[ i ] = aTasks[ i ]();
+        }
+    }
+    return results;
+}
+
+/*!
+ * \brief Read a fixed number of bytes from a pipe.
+ * \param aFD The file descriptor to read from.
+ * \param aBuffer The buffer to read into.
+ * \param aSize The number of bytes to read.
+ * \return Whether all of the bytes were read.
+ */
+bool ForkedWorkers::readFully( const int aFD, void* aBuffer, const size_t aSize ) {
+#if FORKED_WORKERS_ENABLED
+    size_t numRead = 0;
+    while( numRead < aSize ) {
+        const ssize_t currRead = read( aFD, static_cast<char*>( aBuffer ) + numRead, aSize - numRead );
+        if( currRead <= 0 ) {
+            return false;
+        }
+        numRead += currRead;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Write a fixed number of bytes to a pipe.
+ * \param aFD The file descriptor to write to.
+ * \param aBuffer The buffer to write from.
+ * \param aSize The number of bytes to write.
+ * \return Whether all of the bytes were written.
+ */
+bool ForkedWorkers::writeFully( const int aFD, const void* aBuffer, const size_t aSize ) {
+#if FORKED_WORKERS_ENABLED
+    size_t numWritten = 0;
+    while( numWritten < aSize ) {
+        const ssize_t currWritten = write( aFD, static_cast<const char*>( aBuffer ) + numWritten,
+                                           aSize - numWritten );
+        if( currWritten <= 0 ) {
+            return false;
+        }
+        numWritten += currWritten;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
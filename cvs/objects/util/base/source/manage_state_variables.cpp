@@ -39,7 +39,12 @@
  */
 
 #include <cstring>
+#include <algorithm>
 #include <fstream>
+#include <typeinfo>
+#include <unordered_map>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "util/base/include/manage_state_variables.hpp"
 #include "util/base/include/value.h"
@@ -63,6 +68,9 @@ extern Scenario* scenario;
 // ManageStateVariables it seems appropriate to initialize them to NULL here.
 Value::CentralValueType Value::sCentralValue( (double*)0 );
 double* Value::sBaseCentralValue( 0 );
+size_t Value::sNumStateValues( 0 );
+
+unique_ptr<ManageStateVariables::StateLayout> ManageStateVariables::sLayoutCache;
 
 #if GCAM_PARALLEL_ENABLED
 #define NUM_STATES tbb::task_scheduler_init::default_num_threads()+1
@@ -70,6 +78,88 @@ double* Value::sBaseCentralValue( 0 );
 #define NUM_STATES 2
 #endif
 
+/*!
+ * \brief The header written at the start of each restart file.
+ * \details The header is followed by the "base" state data and then the hash
+ *          of the path to each of those states.
+ */
+struct RestartFileHeader {
+    //! Identifies the file as a versioned restart file, always RESTART_FILE_MAGIC.
+    char mMagic[ 8 ];
+    
+    //! The version of the restart file format.
+    uint32_t mVersion;
+    
+    //! Unused, pads the header to keep the state data aligned.
+    uint32_t mReserved;
+    
+    //! The number of states written.
+    uint64_t mNumStates;
+    
+    //! The ManageStateVariables::mLayoutHash of the scenario which wrote the file.
+    uint64_t mLayoutHash;
+};
+
+//! The identifier at the start of every versioned restart file.
+const char RESTART_FILE_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'R', 'S', 'T', '\0' };
+
+//! The current version of the restart file format.
+const uint32_t RESTART_FILE_VERSION = 2;
+
+//! The initial value of each path hash (the FNV-1a offset basis).
+const uint64_t PATH_HASH_SEED = 14695981039346656037ULL;
+
+/*!
+ * \brief Mix the given bytes into a running path hash using FNV-1a.
+ * \param aHash The hash to update.
+ * \param aData The bytes to add to the hash.
+ * \param aSize The number of bytes in aData.
+ * \return The updated hash.
+ */
+static uint64_t hashPathBytes( uint64_t aHash, const void* aData, const size_t aSize ) {
+    const unsigned char* bytes = static_cast<const unsigned char*>( aData );
+    for( size_t i = 0; i < aSize; ++i ) {
+        aHash ^= bytes[ i ];
+        aHash *= 1099511628211ULL;
+    }
+    return aHash;
+}
+
+static uint64_t hashPathString( const uint64_t aHash, const string& aString ) {
+    // include the null terminator so that consecutive strings can not run together
+    return hashPathBytes( aHash, aString.c_str(), aString.size() + 1 );
+}
+
+static uint64_t hashPathInt( const uint64_t aHash, const uint64_t aValue ) {
+    return hashPathBytes( aHash, &aValue, sizeof( uint64_t ) );
+}
+
+/*!
+ * \brief Get the key which identifies a container amongst its siblings in the
+ *        path to a state value.
+ * \details The key is based on the same identifier GCAMFusion would filter the
+ *          container by, its name in this case, so that it does not depend on
+ *          the order containers were read in.
+ * \param aContainer The container being stepped into.
+ * \param aOrdinal The number of siblings which preceded this container.
+ * \return A hash identifying the container.
+ */
+template<typename ContainerType>
+uint64_t getPathKey( const ContainerType* aContainer, const size_t aOrdinal, const NamedFilter* ) {
+    return hashPathString( PATH_HASH_SEED, aContainer->getName() );
+}
+
+template<typename ContainerType>
+uint64_t getPathKey( const ContainerType* aContainer, const size_t aOrdinal, const YearFilter* ) {
+    return hashPathInt( PATH_HASH_SEED, aContainer->getYear() );
+}
+
+template<typename ContainerType>
+uint64_t getPathKey( const ContainerType* aContainer, const size_t aOrdinal, const NoFilter* ) {
+    // containers which can not otherwise be identified use their position
+    return hashPathInt( PATH_HASH_SEED, aOrdinal );
+}
+
 #if GCAM_PARALLEL_ENABLED
 /*!
  * \brief A helper functor to assign a state slot in ManageStateVariables::mStateData
@@ -138,7 +228,9 @@ mStateData( new double*[ NUM_STATES ] ),
 mPeriodToCollect( aPeriod ),
 mYearToCollect( scenario->getModeltime()->getper_to_yr( aPeriod ) ),
 mCCStartYear( mYearToCollect - scenario->getModeltime()->gettimestep( aPeriod ) + 1 ),
-mNumCollected( 0 )
+mNumCollected( 0 ),
+mNumBlocks( 0 ),
+mLayoutHash( PATH_HASH_SEED )
 {
     collectState();
 }
@@ -159,39 +251,114 @@ ManageStateVariables::~ManageStateVariables() {
     Value::sCentralValue.clear();
 #endif
     Value::sBaseCentralValue = 0;
+    Value::sNumStateValues = 0;
 }
 
 /*!
- * \brief Search for all relevant STATE Values and allocate space for them in the
- *        central state data arrays.  The "base" state will get initialized as the
- *        actual value set in the individual Value objects before being collected.
+ * \brief Clear the cached layout of STATE Data so that the next ManageStateVariables
+ *        created will search for it again.
+ * \details This must be called whenever objects which may contain STATE Data are
+ *          created or destroyed after a ManageStateVariables has been created, such
+ *          as when the Scenario is initialized or a policy is replaced.
+ */
+void ManageStateVariables::clearLayoutCache() {
+    sLayoutCache.reset();
+}
+
+/*!
+ * \brief Find the relevant STATE Values, using the cached layout if available, and
+ *        allocate space for them in the central state data arrays.  The "base" state
+ *        will get initialized as the actual value set in the individual Value
+ *        objects before being collected.
  */
 void ManageStateVariables::collectState() {
-    // Set up the GCAM Fusion steps as well as the callback struct that will handle
-    // the results from the search.
-    DoCollect doCollectProc;
-    doCollectProc.mParentClass = this;
-    // Note an empty string for the data name indicates match any name.  The first
-    // step that does not match any name nor value indicates a "descendant" step
-    // allowing for GCAM fusion to search at any depth to find Data of any name
-    // but with the STATE flag set.
-    vector<FilterStep*> collectStateSteps( 2, 0 );
-    collectStateSteps[ 0 ] = new FilterStep( "" );
-    collectStateSteps[ 1 ] = new FilterStep( "", DataFlags::STATE );
-    // DoCollect will handle all fusion callbacks thus their template boolean parameter
-    // are set to true.
-    GCAMFusion<DoCollect, true, true, true> gatherState( doCollectProc, collectStateSteps );
-    gatherState.startFilter( scenario );
+    if( !sLayoutCache ) {
+        sLayoutCache.reset( new StateLayout() );
+        collectLayout( *sLayoutCache );
+    }
+#if DEBUG_STATE
+    else {
+        // double check nothing has changed since the layout was cached
+        StateLayout currLayout;
+        collectLayout( currLayout );
+        bool isSame = currLayout.mSites.size() == sLayoutCache->mSites.size() &&
+            currLayout.mContainerPathHashes == sLayoutCache->mContainerPathHashes;
+        for( size_t i = 0; isSame && i < currLayout.mSites.size(); ++i ) {
+            const StateSite& currSite = currLayout.mSites[ i ];
+            const StateSite& cachedSite = sLayoutCache->mSites[ i ];
+            isSame = currSite.mType == cachedSite.mType && currSite.mData == cachedSite.mData &&
+                currSite.mTechnology == cachedSite.mTechnology && currSite.mMarket == cachedSite.mMarket &&
+                currSite.mContainer == cachedSite.mContainer;
+        }
+        if( !isSame ) {
+            cout << "Cached state layout is stale in period " << mPeriodToCollect << endl;
+            // use the debugger call stack from here to identify where the model
+            // structure changed without calling clearLayoutCache.
+            abort();
+        }
+    }
+#endif
+    
+    // Find the active state in the current period.  The path to each value is that
+    // of the container it was found in and its position amongst the values
+    // collected directly in that container.
+    vector<size_t> numValuesByContainer( sLayoutCache->mContainerPathHashes.size(), 0 );
+    for( const StateSite& site : sLayoutCache->mSites ) {
+        if( !isSiteActive( site ) ) {
+            continue;
+        }
+        switch( site.mType ) {
+            case StateSite::eValue:
+                addStateValue( static_cast<Value*>( site.mData ), site.mContainer, numValuesByContainer );
+                break;
+            case StateSite::ePeriodVector:
+                // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
+                // considered active.
+                addStateValue( &( *static_cast<objects::PeriodVector<Value>*>( site.mData ) )[ mPeriodToCollect ],
+                               site.mContainer, numValuesByContainer );
+                break;
+            case StateSite::eTechVintageVector:
+                // Note, isSiteActive should take care of out of bounds here
+                addStateValue( &( *static_cast<objects::TechVintageVector<Value>*>( site.mData ) )[ mPeriodToCollect ],
+                               site.mContainer, numValuesByContainer );
+                break;
+            case StateSite::eYearVector: {
+                // When a year vector is tagged we only need to worry about values in the current
+                // timestep (already calculated the years ahead of time in the interest of speed
+                // to be from [mCCStartYear, mYearToCollect])
+                objects::YearVector<Value>& data = *static_cast<objects::YearVector<Value>*>( site.mData );
+                for( int year = std::max( mCCStartYear, data.getStartYear() ); year <= mYearToCollect; ++year ) {
+                    addStateValue( &data[ year ], site.mContainer, numValuesByContainer );
+                }
+                break;
+            }
+        }
+    }
     
-    // DoCollect has now gathered all active state into the mStateValues list to
-    // allow faster/easier processing for the remaining tasks at hand.
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::DEBUG );
     mainLog << "Number of active state values: " << mNumCollected << endl;
-    // Allocate space for each active state value for each state slot.
+    
+    // The state values have historically been kept in the reverse of the order
+    // they were found, and restart files depend on that order, so flip them.  We
+    // can then fingerprint the entire layout.
+    reverse( mStateValues.begin(), mStateValues.end() );
+    reverse( mStatePathHashes.begin(), mStatePathHashes.end() );
+    mLayoutHash = hashPathInt( PATH_HASH_SEED, mNumCollected );
+    for( auto pathHash : mStatePathHashes ) {
+        mLayoutHash = hashPathInt( mLayoutHash, pathHash );
+    }
+    
+    // Allocate space for each active state value for each state slot followed
+    // by the dirty flags for each block of values.  The "scratch" slots start
+    // out entirely dirty so that the first copyState fills them completely.
+    mNumBlocks = ( mNumCollected >> Value::STATE_BLOCK_SHIFT ) + 1;
+    const size_t flagSize = ( mNumBlocks + sizeof( double ) - 1 ) / sizeof( double );
     for( size_t stateInd = 0; stateInd < NUM_STATES; ++stateInd ) {
-        mStateData[ stateInd ] = new double[ mNumCollected ];
+        mStateData[ stateInd ] = new double[ mNumCollected + flagSize ];
+        memset( getDirtyFlags( mStateData[ stateInd ] ), stateInd == 0 ? 0 : 1, mNumBlocks );
     }
+    Value::sNumStateValues = mNumCollected;
     
     // We can now initialize the static Value references into mStateData for fast
     // access from within each Value object.
@@ -213,6 +380,34 @@ void ManageStateVariables::collectState() {
     if(  restartPeriod != -1 && mPeriodToCollect < restartPeriod ) {
         loadRestartFile();
     }
+}
+
+/*!
+ * \brief Search for all Data flagged as STATE, active or not, using GCAMFusion.
+ * \param aLayout The layout to add the location of each STATE Data to.
+ */
+void ManageStateVariables::collectLayout( StateLayout& aLayout ) {
+    // Set up the GCAM Fusion steps as well as the callback struct that will handle
+    // the results from the search.
+    DoCollect doCollectProc;
+    doCollectProc.mLayout = &aLayout;
+    DoCollect::PathFrame scenarioFrame = { PATH_HASH_SEED, 0, -1 };
+    doCollectProc.mPathStack.push_back( scenarioFrame );
+    // Note an empty string for the data name indicates match any name.  The first
+    // step that does not match any name nor value indicates a "descendant" step
+    // allowing for GCAM fusion to search at any depth to find Data of any name
+    // but with the STATE flag set.
+    vector<FilterStep*> collectStateSteps( 2, 0 );
+    collectStateSteps[ 0 ] = new FilterStep( "" );
+    collectStateSteps[ 1 ] = new FilterStep( "", DataFlags::STATE );
+    // DoCollect will handle all fusion callbacks thus their template boolean parameter
+    // are set to true.
+    GCAMFusion<DoCollect, true, true, true> gatherState( doCollectProc, collectStateSteps );
+    gatherState.startFilter( scenario );
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::DEBUG );
+    mainLog << "Number of state data found: " << aLayout.mSites.size() << endl;
     
     // clean up GCAMFusion related memory
     for( auto filterStep : collectStateSteps ) {
@@ -220,6 +415,37 @@ void ManageStateVariables::collectState() {
     }
 }
 
+/*!
+ * \brief Check if the given STATE Data could possibly be changed during
+ *        World.calc( mPeriodToCollect ).
+ * \details Data set within a Technology that is not operating or a Market which
+ *          is not for the current model year is ignored.
+ * \param aSite The STATE Data to check.
+ * \return True if the Data is active state in the current period.
+ */
+bool ManageStateVariables::isSiteActive( const StateSite& aSite ) const {
+    return ( !aSite.mTechnology || aSite.mTechnology->isOperating( mPeriodToCollect ) ) &&
+           ( !aSite.mMarket || aSite.mMarket->getYear() == mYearToCollect );
+}
+
+/*!
+ * \brief Add the given Value to the collected state and record the hash of its
+ *        path which is that of the container it was found in and the position of
+ *        the Value amongst those collected directly in it.
+ * \param aValue A Value which is active state.
+ * \param aContainer The index into StateLayout::mContainerPathHashes of the
+ *                   container aValue was found in.
+ * \param aNumValuesByContainer The number of values collected so far by container.
+ */
+void ManageStateVariables::addStateValue( Value* aValue, const size_t aContainer,
+                                          vector<size_t>& aNumValuesByContainer )
+{
+    mStateValues.push_back( aValue );
+    mStatePathHashes.push_back( hashPathInt( sLayoutCache->mContainerPathHashes[ aContainer ],
+                                             aNumValuesByContainer[ aContainer ]++ ) );
+    ++mNumCollected;
+}
+
 /*!
  * \brief Copy the "base" state back into each corresponding Value object before
  *        we move on from this model period and release the state memory.
@@ -251,23 +477,63 @@ void ManageStateVariables::resetState() {
  *          calculation which will make changes in the "scratch" space.  Note when
  *          GCAM_PARALLEL_ENABLED the appropriate "scratch" space to reset is identified
  *          as the one assigned to the calling thread via the thread local Value::sCentralValue.
+ *          Only blocks flagged as dirty, either because they were written by the
+ *          previous partial derivative on this slot or because the "base" state
+ *          changed since, are copied.
  */
 void ManageStateVariables::copyState() {
 #if !GCAM_PARALLEL_ENABLED
-    memcpy( mStateData[1], mStateData[0], (sizeof( double)) * mNumCollected );
+    double* scratch = mStateData[1];
 #else
-    memcpy( Value::sCentralValue.local(), mStateData[0], (sizeof( double)) * mNumCollected );
+    double* scratch = Value::sCentralValue.local();
 #endif
+    unsigned char* dirty = getDirtyFlags( scratch );
+    const size_t blockSize = size_t( 1 ) << Value::STATE_BLOCK_SHIFT;
+    for( size_t block = 0; block < mNumBlocks; ++block ) {
+        if( dirty[ block ] ) {
+            const size_t start = block * blockSize;
+            const size_t count = std::min( blockSize, mNumCollected - start );
+            memcpy( scratch + start, mStateData[0] + start, (sizeof( double)) * count );
+            dirty[ block ] = 0;
+        }
+    }
+}
+
+/*!
+ * \brief Get the dirty flags which are stored just past the end of the state
+ *        values in the given slot of mStateData.
+ * \param aState A slot in mStateData.
+ * \return The dirty flag for each block of values in aState.
+ */
+unsigned char* ManageStateVariables::getDirtyFlags( double* aState ) const {
+    return reinterpret_cast<unsigned char*>( aState + mNumCollected );
 }
 
 /*!
  * \brief Set up the Value classes static references into mStateData to appropriately
  *        point to the "base" state if aIsPartialDeriv is false or a "scratch"
  *        space if aIsPartialDeriv is true.
+ * \details When entering partial derivative mode the blocks of "base" state that
+ *          have changed are flagged as dirty in each "scratch" space so that
+ *          copyState will pick up the changes.
  * \param aIsPartialDeriv The flag indicating if we are about to calculate a partial
  *                        derivative or not as set from the solution algorithm.
  */
 void ManageStateVariables::setPartialDeriv( const bool aIsPartialDeriv ) {
+    if( aIsPartialDeriv ) {
+        // Any block of the "base" state that has been changed since the last
+        // time we started partial derivatives is now stale in every "scratch"
+        // space.  Note all writes go to the "scratch" space while in partial
+        // derivative mode so we only need to check at this transition.
+        unsigned char* baseDirty = getDirtyFlags( mStateData[0] );
+        for( size_t stateInd = 1; stateInd < NUM_STATES; ++stateInd ) {
+            unsigned char* dirty = getDirtyFlags( mStateData[ stateInd ] );
+            for( size_t block = 0; block < mNumBlocks; ++block ) {
+                dirty[ block ] |= baseDirty[ block ];
+            }
+        }
+        memset( baseDirty, 0, mNumBlocks );
+    }
 #if !GCAM_PARALLEL_ENABLED
     Value::sCentralValue = mStateData[ aIsPartialDeriv ? 1 : 0 ];
 #else
@@ -301,58 +567,122 @@ string ManageStateVariables::getRestartFileName() const {
 
 /*!
  * \brief Load a restart file from disk directly into the "base" state.
- * \warning Very little error checking is done to ensure the state read in was generated
- *          from the exact same scenario.  All we can do in terms of error checking is
- *          check that the size of the data coming in is exactly the same size as mNumCollected.
+ * \details The file is memory mapped so that the state data can be copied
+ *          straight into mStateData[0] without any intermediate buffering.  If
+ *          the layout fingerprint in the header matches mLayoutHash the file was
+ *          generated from the same scenario structure and the data is copied in
+ *          one shot.  Otherwise, if the bool restart-warm-start is set, each
+ *          state value is matched by the hash of its GCAMFusion path so that a
+ *          restart generated from a structurally similar scenario may be used to
+ *          warm start this one.  Values that could not be matched keep the value
+ *          they were initialized with.  Restart files in the original headerless
+ *          format are still accepted however they can only be checked by size.
  * \sa ManageStateVariables::getRestartFileName
  * \sa ManageStateVariables::saveRestartFile
  */
 void ManageStateVariables::loadRestartFile() {
-    // read from the appropriate file which is in binary format
+    using namespace boost::interprocess;
     const string restartFileName = getRestartFileName();
-    fstream restartFile( restartFileName.c_str(), ios_base::in | ios_base::binary );
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
     
-    if( !restartFile.is_open() ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
+    file_mapping restartFile;
+    mapped_region restartRegion;
+    try {
+        file_mapping( restartFileName.c_str(), read_only ).swap( restartFile );
+        mapped_region( restartFile, read_only ).swap( restartRegion );
+    }
+    catch( const interprocess_exception& aException ) {
         mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Could not open restart file: " << restartFileName << " for read." << endl;
+        mainLog << "Could not open restart file: " << restartFileName << " for read: " << aException.what() << endl;
         abort();
     }
+    const char* buffer = static_cast<const char*>( restartRegion.get_address() );
+    const size_t fileSize = restartRegion.get_size();
     
-    size_t numStatesInRestart;
-    restartFile.read( reinterpret_cast<char*>( &numStatesInRestart ), sizeof( size_t ) );
-    if( numStatesInRestart != mNumCollected ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const bool isVersioned = fileSize >= sizeof( RestartFileHeader ) &&
+        memcmp( buffer, RESTART_FILE_MAGIC, sizeof( RESTART_FILE_MAGIC ) ) == 0;
+    if( !isVersioned ) {
+        // Not a versioned restart file, the original format is just the number of
+        // states followed by the state data.
+        size_t numStatesInRestart = 0;
+        if( fileSize >= sizeof( size_t ) ) {
+            memcpy( &numStatesInRestart, buffer, sizeof( size_t ) );
+        }
+        if( numStatesInRestart != mNumCollected || fileSize != sizeof( size_t ) + sizeof( double ) * numStatesInRestart ) {
+            mainLog.setLevel( ILogger::SEVERE );
+            mainLog << "Restart file: " << restartFileName << " differs in size, read: " << numStatesInRestart
+                    << ", expected: " << mNumCollected << endl;
+            abort();
+        }
+        memcpy( mStateData[0], buffer + sizeof( size_t ), sizeof( double ) * numStatesInRestart );
+        return;
+    }
+    
+    RestartFileHeader header;
+    memcpy( &header, buffer, sizeof( RestartFileHeader ) );
+    if( header.mVersion != RESTART_FILE_VERSION ) {
         mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " differs in size, read: " << numStatesInRestart
-                << ", expected: " << mNumCollected << endl;
+        mainLog << "Restart file: " << restartFileName << " has unsupported version " << header.mVersion
+                << ", expected: " << RESTART_FILE_VERSION << endl;
         abort();
     }
+    const size_t numStatesInRestart = static_cast<size_t>( header.mNumStates );
+    if( fileSize != sizeof( RestartFileHeader ) + ( sizeof( double ) + sizeof( uint64_t ) ) * numStatesInRestart ) {
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Restart file: " << restartFileName << " is truncated or corrupt, expected "
+                << numStatesInRestart << " states." << endl;
+        abort();
+    }
+    const char* restartData = buffer + sizeof( RestartFileHeader );
     
-    // read the binary data directly into the "base" state
-    restartFile.read( reinterpret_cast<char*>( mStateData[0] ), sizeof( double ) * numStatesInRestart );
-    if( !restartFile ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( header.mLayoutHash == mLayoutHash && numStatesInRestart == mNumCollected ) {
+        // read the binary data directly into the "base" state
+        memcpy( mStateData[0], restartData, sizeof( double ) * numStatesInRestart );
+        return;
+    }
+    
+    if( !Configuration::getInstance()->getBool( "restart-warm-start", false, false ) ) {
         mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " has fewer states than expected, read: " << static_cast<size_t>( (restartFile.gcount() - sizeof(size_t)) / sizeof(double))
-                << ", expected: " << numStatesInRestart << endl;
+        mainLog << "Restart file: " << restartFileName << " was generated from a different scenario structure, read: "
+                << numStatesInRestart << " states, expected: " << mNumCollected
+                << ".  Set restart-warm-start to match state by path instead." << endl;
         abort();
     }
-    if( restartFile.peek() != EOF ) {
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
+    
+    // Warm start by matching the path of each state value in the restart file
+    // to those collected in this scenario.
+    const char* restartPaths = restartData + sizeof( double ) * numStatesInRestart;
+    unordered_map<uint64_t, size_t> stateIndexByPath( mNumCollected );
+    for( size_t stateInd = 0; stateInd < mNumCollected; ++stateInd ) {
+        stateIndexByPath[ mStatePathHashes[ stateInd ] ] = stateInd;
+    }
+    size_t numMatched = 0;
+    for( size_t restartInd = 0; restartInd < numStatesInRestart; ++restartInd ) {
+        uint64_t path;
+        memcpy( &path, restartPaths + sizeof( uint64_t ) * restartInd, sizeof( uint64_t ) );
+        auto matchIter = stateIndexByPath.find( path );
+        if( matchIter != stateIndexByPath.end() ) {
+            memcpy( mStateData[0] + (*matchIter).second, restartData + sizeof( double ) * restartInd, sizeof( double ) );
+            ++numMatched;
+        }
+    }
+    if( numMatched == 0 ) {
         mainLog.setLevel( ILogger::SEVERE );
-        mainLog << "Restart file: " << restartFileName << " has more states than expected: " << numStatesInRestart << endl;
+        mainLog << "Restart file: " << restartFileName << " does not share any state with the current scenario." << endl;
         abort();
     }
-
-    restartFile.close();
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Warm starting from restart file: " << restartFileName << " matched " << numMatched
+            << " of " << mNumCollected << " states by path." << endl;
 }
 
 /*!
  * \brief Dump the contents of the "base" state array into a binary restart file.
- * \details The first value written is mNumCollected (size written: size_t) to help with do some error checking
- *          when we try to read it back in.  Then we just write the entire content of mStateData[0]
- *          (size written: double * mNumCollected).
+ * \details The file starts with a RestartFileHeader which includes the number of
+ *          states and mLayoutHash to help with error checking when we try to
+ *          read it back in.  Then we write the entire content of mStateData[0]
+ *          (size written: double * mNumCollected) followed by mStatePathHashes
+ *          (size written: uint64_t * mNumCollected) to allow matching by path.
  * \sa ManageStateVariables::getRestartFileName
  */
 void ManageStateVariables::saveRestartFile() {
@@ -369,13 +699,22 @@ void ManageStateVariables::saveRestartFile() {
         abort();
     }
     
-    // first write the total number of entries that should be expected to help with error
-    // checking on read in
-    restartFile.write( reinterpret_cast<char*>( &mNumCollected ), sizeof( size_t ) );
+    // first write the header which identifies the version, total number of
+    // entries and the state layout to help with error checking on read in
+    RestartFileHeader header;
+    memset( &header, 0, sizeof( RestartFileHeader ) );
+    memcpy( header.mMagic, RESTART_FILE_MAGIC, sizeof( header.mMagic ) );
+    header.mVersion = RESTART_FILE_VERSION;
+    header.mNumStates = mNumCollected;
+    header.mLayoutHash = mLayoutHash;
+    restartFile.write( reinterpret_cast<char*>( &header ), sizeof( RestartFileHeader ) );
     
     // write the entire contents of the "base" state
     restartFile.write( reinterpret_cast<char*>( mStateData[0] ), sizeof( double ) * mNumCollected );
     
+    // write the path to each state so that we can match by path if necessary
+    restartFile.write( reinterpret_cast<const char*>( mStatePathHashes.data() ), sizeof( uint64_t ) * mNumCollected );
+    
     restartFile.close();
     
     mainLog << "Done." << endl;
@@ -406,84 +745,94 @@ template<>
 void ManageStateVariables::DoCollect::processData<Value>( Value& aData ) {
     // Any SINGLE value that is tagged is considered active so long as it is not
     // contained in a retired technology for instance.
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData );
-        ++mParentClass->mNumCollected;
-    }
+    addSite( StateSite::eValue, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::PeriodVector<Value> >( objects::PeriodVector<Value>& aData ) {
-    // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
-    // considered active.
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData[ mParentClass->mPeriodToCollect ] );
-        ++mParentClass->mNumCollected;
-    }
+    addSite( StateSite::ePeriodVector, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::TechVintageVector<Value> >( objects::TechVintageVector<Value>& aData ) {
-    // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
-    // considered active.
-    
-    // Note, mIgnoreCurrValue should take care of out of bounds here
-    if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData[ mParentClass->mPeriodToCollect ] );
-        ++mParentClass->mNumCollected;
-    }
+    addSite( StateSite::eTechVintageVector, &aData );
 }
 
 template<>
 void ManageStateVariables::DoCollect::processData<objects::YearVector<Value> >( objects::YearVector<Value>& aData ) {
-    // When a year vector is tagged we only need to worry about values in the current
-    // timestep (already calculated the years ahead of time in the interest of speed
-    // to be from [mCCStartYear, mYearToCollect])
-    if( !mIgnoreCurrValue ) {
-        for( int year = std::max( mParentClass->mCCStartYear, aData.getStartYear() ); year <= mParentClass->mYearToCollect; ++year ) {
-            mParentClass->mStateValues.push_front( &aData[ year ] );
-            ++mParentClass->mNumCollected;
-        }
+    addSite( StateSite::eYearVector, &aData );
+}
+
+/*!
+ * \brief Add the given STATE Data to the layout along with the Technology or
+ *        Market it is contained in, if any, and the container it was found in.
+ * \param aType The type of aData.
+ * \param aData The STATE Data.
+ */
+void ManageStateVariables::DoCollect::addSite( const StateSite::SiteType aType, void* aData ) {
+    PathFrame& currFrame = mPathStack.back();
+    if( currFrame.mContainer == -1 ) {
+        currFrame.mContainer = static_cast<int>( mLayout->mContainerPathHashes.size() );
+        mLayout->mContainerPathHashes.push_back( currFrame.mHash );
     }
+    StateSite site = { aType, aData, mCurrTechnology, mCurrMarket, static_cast<size_t>( currFrame.mContainer ) };
+    mLayout->mSites.push_back( site );
+}
+
+/*!
+ * \brief Step into a child container of the current one in mPathStack.
+ * \param aKey The key identifying the child container amongst its siblings.
+ */
+void ManageStateVariables::DoCollect::pushPath( const uint64_t aKey ) {
+    PathFrame& parentFrame = mPathStack.back();
+    ++parentFrame.mNumChildren;
+    PathFrame childFrame = { hashPathInt( parentFrame.mHash, aKey ), 0, -1 };
+    mPathStack.push_back( childFrame );
 }
 
 template<typename DataType>
 void ManageStateVariables::DoCollect::pushFilterStep( const DataType& aData ) {
-    // ignore most steps
+    // Most steps only need to be tracked to build the path to the state values.
+    // Note the type of container is included so that for instance an input and
+    // output of the same name are distinguished.
+    using ContainerType = typename boost::remove_pointer<DataType>::type;
+    using ContainerIDFilterType = typename GetFilterForContainer<ContainerType>::filter_type;
+    const uint64_t key = getPathKey( aData, mPathStack.back().mNumChildren, static_cast<const ContainerIDFilterType*>( 0 ) );
+    pushPath( hashPathString( key, typeid( DataType ).name() ) );
 }
 
 template<typename DataType>
 void ManageStateVariables::DoCollect::popFilterStep( const DataType& aData ) {
-    // ignore most steps
+    mPathStack.pop_back();
 }
 
 
 template<>
 void ManageStateVariables::DoCollect::pushFilterStep<ITechnology*>( ITechnology* const& aData ) {
-    // Ignore any data set within a Technology that is not operating in the current
-    // model period.
-    if( !aData->isOperating( mParentClass->mPeriodToCollect ) ) {
-        mIgnoreCurrValue = true;
-    }
+    pushPath( hashPathInt( hashPathString( PATH_HASH_SEED, aData->getName() ), aData->getYear() ) );
+    // Keep track of the Technology so that any data set within it can be ignored
+    // in periods it is not operating.
+    mCurrTechnology = aData;
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<ITechnology*>( ITechnology* const& aData ) {
-    // Moving out of the current Technology so reset the ignore flag.
-    mIgnoreCurrValue = false;
+    mPathStack.pop_back();
+    // Moving out of the current Technology.
+    mCurrTechnology = 0;
 }
 
 template<>
 void ManageStateVariables::DoCollect::pushFilterStep<Market*>( Market* const& aData ) {
-    // Ignore any data set within a Market which is not for the current model year.
-    if( aData->getYear() != mParentClass->mYearToCollect ) {
-        mIgnoreCurrValue = true;
-    }
+    pushPath( hashPathInt( hashPathString( PATH_HASH_SEED, aData->getName() ), aData->getYear() ) );
+    // Keep track of the Market so that any data set within it can be ignored
+    // unless it is for the current model year.
+    mCurrMarket = aData;
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<Market*>( Market* const& aData ) {
-    // Moving out of the current Market so reset the ignore flag.
-    mIgnoreCurrValue = false;
+    mPathStack.pop_back();
+    // Moving out of the current Market.
+    mCurrMarket = 0;
 }
-
@@ -145,7 +145,7 @@ void SupplyDemandCurveSaver::printCSV( ostream& aOut, Scenario* aScenario,
     SolutionInfoSet solnInfoSet = SolutionInfoSet( marketplace );
     SolutionInfoParamParser solnParams;
     solnInfoSet.init( aPeriod, 0.001, 0.001, &solnParams );
-    vector<SolutionInfo> solvable = solnInfoSet.getSolvableSet();
+    const vector<SolutionInfo>& solvable = solnInfoSet.getSolvableSet();
 
     int market_index = getMarketIndex(mName, solvable);
 
@@ -162,7 +162,7 @@ void SupplyDemandCurveSaver::printCSV( ostream& aOut, Scenario* aScenario,
 
 /*! \brief Find the given marketName in the solvable markets and return its index, if found, else -1.
  */
-int SupplyDemandCurveSaver::getMarketIndex(const string& marketName, vector<SolutionInfo> &aSolvable ) {
+int SupplyDemandCurveSaver::getMarketIndex(const string& marketName, const vector<SolutionInfo> &aSolvable ) {
     for ( int i = 0; i < aSolvable.size(); ++i ) {
         if ( aSolvable[ i ].getName() == marketName )
             return i;
@@ -0,0 +1,458 @@
+/*
+ * LEGAL NOTICE
+ * This computer software was prepared by Battelle Memorial Institute,
+ * hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+ * with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+ * CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+ * LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+ * sentence must appear on any copies of this computer software.
+ * 
+ * EXPORT CONTROL
+ * User agrees that the Software will not be shipped, transferred or
+ * exported into any country or used in any manner prohibited by the
+ * United States Export Administration Act or any other applicable
+ * export laws, restrictions or regulations (collectively the "Export Laws").
+ * Export of the Software may require some form of license or other
+ * authority from the U.S. Government, and failure to obtain such
+ * export control license may result in criminal liability under
+ * U.S. laws. In addition, if the Software is identified as export controlled
+ * items under the Export Laws, User represents and warrants that User
+ * is not a citizen, or otherwise located within, an embargoed nation
+ * (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+ *     and that User is not otherwise prohibited
+ * under the Export Laws from receiving the Software.
+ * 
+ * Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+ * Distributed as open-source under the terms of the Educational Community 
+ * License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+ * 
+ * For further details, see: http://www.globalchange.umd.edu/models/gcam/
+ *
+ */
+
+
+/*! 
+* \file xml_parse_cache.cpp
+* \ingroup Objects
+* \brief XMLParseCache class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cerrno>
+#include <sys/stat.h>
+#if defined( _MSC_VER )
+#include <direct.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMText.hpp>
+#include <xercesc/dom/DOMNamedNodeMap.hpp>
+#include <xercesc/dom/DOMImplementation.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#include "util/base/include/xml_parse_cache.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+/*!
+ * \brief The header written at the start of each cache file.
+ * \details The header is followed by the table of strings, each of which is
+ *          the length followed by the null terminated characters padded to a
+ *          whole number of words, and then the words which describe the nodes.
+ *          Each element is written as its tag, name, number of attributes and
+ *          the name and value of each, number of children and then the children.
+ *          Each text node is written as its tag and value.  Strings are referred
+ *          to by their index into the table.
+ */
+struct XMLCacheFileHeader {
+    //! Identifies the file as an XML cache file, always XML_CACHE_FILE_MAGIC.
+    char mMagic[ 8 ];
+    
+    //! The version of the cache file format.
+    uint32_t mVersion;
+    
+    //! The size of XMLCh, which differs by platform, the file was written with.
+    uint32_t mCharSize;
+    
+    //! The number of strings in the string table.
+    uint32_t mNumStrings;
+    
+    //! The number of words used to describe the nodes.
+    uint32_t mNumNodeWords;
+};
+
+//! The identifier at the start of every cache file.
+const char XML_CACHE_FILE_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'X', 'M', 'L', 'C' };
+
+//! The current version of the cache file format.
+const uint32_t XML_CACHE_FILE_VERSION = 1;
+
+//! The tags identifying the type of each node written.
+enum XMLCacheNodeTag {
+    ELEMENT_TAG,
+    TEXT_TAG
+};
+
+/*!
+ * \brief Adds nodes to a cache file as a DOM document is traversed.
+ */
+struct XMLCacheWriter {
+    //! The string table.
+    vector<const XMLCh*> mStrings;
+    
+    //! The index of each string in mStrings keyed by its raw bytes.
+    unordered_map<string, uint32_t> mStringIndex;
+    
+    //! The words describing the nodes.
+    vector<uint32_t> mNodeWords;
+    
+    uint32_t addString( const XMLCh* aString ) {
+        const string key( reinterpret_cast<const char*>( aString ), XMLString::stringLen( aString ) * sizeof( XMLCh ) );
+        auto found = mStringIndex.find( key );
+        if( found != mStringIndex.end() ) {
+            return (*found).second;
+        }
+        const uint32_t index = static_cast<uint32_t>( mStrings.size() );
+        mStrings.push_back( aString );
+        mStringIndex[ key ] = index;
+        return index;
+    }
+    
+    void addNode( const DOMNode* aNode ) {
+        if( aNode->getNodeType() == DOMNode::ELEMENT_NODE ) {
+            mNodeWords.push_back( ELEMENT_TAG );
+            mNodeWords.push_back( addString( aNode->getNodeName() ) );
+            const DOMNamedNodeMap* attrs = aNode->getAttributes();
+            const XMLSize_t numAttrs = attrs ? attrs->getLength() : 0;
+            mNodeWords.push_back( static_cast<uint32_t>( numAttrs ) );
+            for( XMLSize_t attrInd = 0; attrInd < numAttrs; ++attrInd ) {
+                const DOMNode* attr = attrs->item( attrInd );
+                mNodeWords.push_back( addString( attr->getNodeName() ) );
+                mNodeWords.push_back( addString( attr->getNodeValue() ) );
+            }
+            // The number of children is only known after they have been filtered
+            // so leave a place holder for now.
+            const size_t numChildrenPos = mNodeWords.size();
+            mNodeWords.push_back( 0 );
+            uint32_t numChildren = 0;
+            for( const DOMNode* child = aNode->getFirstChild(); child; child = child->getNextSibling() ) {
+                const short childType = child->getNodeType();
+                if( childType == DOMNode::ELEMENT_NODE || childType == DOMNode::TEXT_NODE ||
+                    childType == DOMNode::CDATA_SECTION_NODE )
+                {
+                    addNode( child );
+                    ++numChildren;
+                }
+            }
+            mNodeWords[ numChildrenPos ] = numChildren;
+        }
+        else {
+            mNodeWords.push_back( TEXT_TAG );
+            mNodeWords.push_back( addString( aNode->getNodeValue() ) );
+        }
+    }
+};
+
+/*!
+ * \brief Rebuilds DOM nodes from a cache file.
+ * \details All reads are checked against the bounds of the file so that a
+ *          corrupt cache file is detected rather than causing a crash.
+ */
+struct XMLCacheReader {
+    //! The document to create nodes in.
+    DOMDocument* mDocument;
+    
+    //! Pointers to each null terminated string in the string table.
+    vector<const XMLCh*> mStrings;
+    
+    //! The current position in the node words.
+    const uint32_t* mPos;
+    
+    //! The end of the node words.
+    const uint32_t* mEnd;
+    
+    bool readWord( uint32_t& aWord ) {
+        if( mPos == mEnd ) {
+            return false;
+        }
+        memcpy( &aWord, mPos++, sizeof( uint32_t ) );
+        return true;
+    }
+    
+    bool readString( const XMLCh*& aString ) {
+        uint32_t index;
+        if( !readWord( index ) || index >= mStrings.size() ) {
+            return false;
+        }
+        aString = mStrings[ index ];
+        return true;
+    }
+    
+    DOMNode* readNode() {
+        uint32_t tag;
+        const XMLCh* name;
+        if( !readWord( tag ) || !readString( name ) ) {
+            return 0;
+        }
+        if( tag == TEXT_TAG ) {
+            return mDocument->createTextNode( name );
+        }
+        else if( tag != ELEMENT_TAG ) {
+            return 0;
+        }
+        DOMElement* element = mDocument->createElement( name );
+        uint32_t numAttrs;
+        if( !readWord( numAttrs ) ) {
+            return 0;
+        }
+        for( uint32_t attrInd = 0; attrInd < numAttrs; ++attrInd ) {
+            const XMLCh* attrName;
+            const XMLCh* attrValue;
+            if( !readString( attrName ) || !readString( attrValue ) ) {
+                return 0;
+            }
+            element->setAttribute( attrName, attrValue );
+        }
+        uint32_t numChildren;
+        if( !readWord( numChildren ) ) {
+            return 0;
+        }
+        for( uint32_t childInd = 0; childInd < numChildren; ++childInd ) {
+            DOMNode* child = readNode();
+            if( !child ) {
+                return 0;
+            }
+            element->appendChild( child );
+        }
+        return element;
+    }
+};
+
+/*!
+ * \brief Returns whether the cache is enabled.
+ * \details The cache is enabled by setting the xml-input-cache file in the
+ *          configuration, which is the directory to write cache files to, with
+ *          write-output set.
+ * \return Whether the cache is enabled.
+ */
+bool XMLParseCache::isEnabled() {
+    const Configuration* conf = Configuration::getInstance();
+    return conf->shouldWriteFile( "xml-input-cache", false, false ) &&
+        !conf->getFile( "xml-input-cache", "", false ).empty();
+}
+
+/*!
+ * \brief Get the name of the cache file for the given input file.
+ * \details The name is the hash of the contents of the input file so that any
+ *          change to the file will use a new cache file.
+ * \param aXMLFile The input file.
+ * \return The name of the cache file or the empty string if the input file could
+ *         not be read.
+ */
+string XMLParseCache::getCacheFileName( const string& aXMLFile ) {
+    using namespace boost::interprocess;
+    uint64_t hash = 14695981039346656037ULL;
+    try {
+        file_mapping inputFile( aXMLFile.c_str(), read_only );
+        mapped_region inputRegion( inputFile, read_only );
+        const unsigned char* bytes = static_cast<const unsigned char*>( inputRegion.get_address() );
+        const size_t size = inputRegion.get_size();
+        for( size_t i = 0; i < size; ++i ) {
+            hash ^= bytes[ i ];
+            hash *= 1099511628211ULL;
+        }
+    }
+    catch( const interprocess_exception& ) {
+        return "";
+    }
+    
+    ostringstream cacheFileName;
+    cacheFileName << Configuration::getInstance()->getFile( "xml-input-cache", "", false ) << "/"
+                  << hex << setw( 16 ) << setfill( '0' ) << hash << ".xmlc";
+    return cacheFileName.str();
+}
+
+/*!
+ * \brief Create the directory which will contain the given cache file, along
+ *        with any missing parent directories.
+ * \details Failure is not reported here as opening the cache file for write
+ *          will then fail and get reported.
+ * \param aCacheFileName The name of the cache file.
+ */
+void XMLParseCache::createCacheDirectory( const string& aCacheFileName ) {
+    const size_t dirEnd = aCacheFileName.find_last_of( "/\\" );
+    for( size_t pos = aCacheFileName.find_first_of( "/\\", 1 ); pos != string::npos && pos <= dirEnd;
+         pos = aCacheFileName.find_first_of( "/\\", pos + 1 ) )
+    {
+        const string dir = aCacheFileName.substr( 0, pos );
+        if( dir[ dir.size() - 1 ] == ':' ) {
+            // A drive letter which can not be created.
+            continue;
+        }
+#if defined( _MSC_VER )
+        const int result = _mkdir( dir.c_str() );
+#else
+        const int result = mkdir( dir.c_str(), 0777 );
+#endif
+        if( result != 0 && errno != EEXIST ) {
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief Load the DOM document for the given input file from the cache.
+ * \param aXMLFile The input file.
+ * \return The document, which the caller must release, or null if it was not in
+ *         the cache in which case the input file should be parsed.
+ */
+DOMDocument* XMLParseCache::loadDocument( const string& aXMLFile ) {
+    using namespace boost::interprocess;
+    const string cacheFileName = getCacheFileName( aXMLFile );
+    if( cacheFileName.empty() ) {
+        return 0;
+    }
+    
+    file_mapping cacheFile;
+    mapped_region cacheRegion;
+    try {
+        file_mapping( cacheFileName.c_str(), read_only ).swap( cacheFile );
+        mapped_region( cacheFile, read_only ).swap( cacheRegion );
+    }
+    catch( const interprocess_exception& ) {
+        // not cached yet
+        return 0;
+    }
+    const char* buffer = static_cast<const char*>( cacheRegion.get_address() );
+    const char* bufferEnd = buffer + cacheRegion.get_size();
+    
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    XMLCacheFileHeader header;
+    memset( &header, 0, sizeof( XMLCacheFileHeader ) );
+    if( cacheRegion.get_size() >= sizeof( XMLCacheFileHeader ) ) {
+        memcpy( &header, buffer, sizeof( XMLCacheFileHeader ) );
+    }
+    if( memcmp( header.mMagic, XML_CACHE_FILE_MAGIC, sizeof( header.mMagic ) ) != 0 ||
+        header.mVersion != XML_CACHE_FILE_VERSION || header.mCharSize != sizeof( XMLCh ) )
+    {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Ignoring incompatible XML cache file " << cacheFileName << " for " << aXMLFile << endl;
+        return 0;
+    }
+    
+    // Set up the string table to point directly into the cache file.
+    XMLCacheReader reader;
+    reader.mStrings.reserve( header.mNumStrings );
+    const char* pos = buffer + sizeof( XMLCacheFileHeader );
+    for( uint32_t strInd = 0; strInd < header.mNumStrings; ++strInd ) {
+        uint32_t length;
+        if( pos + sizeof( uint32_t ) > bufferEnd ) {
+            break;
+        }
+        memcpy( &length, pos, sizeof( uint32_t ) );
+        pos += sizeof( uint32_t );
+        const size_t numBytes = ( ( ( length + 1 ) * sizeof( XMLCh ) + sizeof( uint32_t ) - 1 ) / sizeof( uint32_t ) ) * sizeof( uint32_t );
+        if( pos + numBytes > bufferEnd ) {
+            break;
+        }
+        reader.mStrings.push_back( reinterpret_cast<const XMLCh*>( pos ) );
+        pos += numBytes;
+    }
+    if( reader.mStrings.size() != header.mNumStrings ||
+        pos + sizeof( uint32_t ) * header.mNumNodeWords != bufferEnd )
+    {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Ignoring corrupt XML cache file " << cacheFileName << " for " << aXMLFile << endl;
+        return 0;
+    }
+    reader.mPos = reinterpret_cast<const uint32_t*>( pos );
+    reader.mEnd = reinterpret_cast<const uint32_t*>( bufferEnd );
+    
+    reader.mDocument = DOMImplementation::getImplementation()->createDocument();
+    DOMNode* root = reader.readNode();
+    if( !root || reader.mPos != reader.mEnd ) {
+        reader.mDocument->release();
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Ignoring corrupt XML cache file " << cacheFileName << " for " << aXMLFile << endl;
+        return 0;
+    }
+    reader.mDocument->appendChild( root );
+    XMLCh* documentURI = XMLString::transcode( aXMLFile.c_str() );
+    reader.mDocument->setDocumentURI( documentURI );
+    XMLString::release( &documentURI );
+    
+    mainLog.setLevel( ILogger::DEBUG );
+    mainLog << "Loaded " << aXMLFile << " from XML cache file " << cacheFileName << endl;
+    return reader.mDocument;
+}
+
+/*!
+ * \brief Save the DOM document parsed from the given input file to the cache.
+ * \details Failure to write the cache file is not an error, the input file will
+ *          just get parsed again next time.
+ * \param aXMLFile The input file.
+ * \param aDocument The document parsed from aXMLFile.
+ */
+void XMLParseCache::saveDocument( const string& aXMLFile, const DOMDocument* aDocument ) {
+    const string cacheFileName = getCacheFileName( aXMLFile );
+    if( cacheFileName.empty() || !aDocument || !aDocument->getDocumentElement() ) {
+        return;
+    }
+    
+    XMLCacheWriter writer;
+    writer.addNode( aDocument->getDocumentElement() );
+    
+    // Write to a temporary file and move it into place once complete so that
+    // concurrent runs never see a partially written cache file.  The process id
+    // keeps the temporary file distinct from that of any other run.
+    createCacheDirectory( cacheFileName );
+    const string tempFileName = cacheFileName + ".tmp" + util::toString( static_cast<long>( getpid() ) );
+    ofstream cacheFile( tempFileName.c_str(), ios_base::out | ios_base::trunc | ios_base::binary );
+    if( !cacheFile.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not open XML cache file " << tempFileName << " for write." << endl;
+        return;
+    }
+    
+    XMLCacheFileHeader header;
+    memset( &header, 0, sizeof( XMLCacheFileHeader ) );
+    memcpy( header.mMagic, XML_CACHE_FILE_MAGIC, sizeof( header.mMagic ) );
+    header.mVersion = XML_CACHE_FILE_VERSION;
+    header.mCharSize = sizeof( XMLCh );
+    header.mNumStrings = static_cast<uint32_t>( writer.mStrings.size() );
+    header.mNumNodeWords = static_cast<uint32_t>( writer.mNodeWords.size() );
+    cacheFile.write( reinterpret_cast<const char*>( &header ), sizeof( XMLCacheFileHeader ) );
+    
+    const char padding[ sizeof( uint32_t ) ] = { 0 };
+    for( auto currString : writer.mStrings ) {
+        const uint32_t length = static_cast<uint32_t>( XMLString::stringLen( currString ) );
+        const size_t numBytes = ( length + 1 ) * sizeof( XMLCh );
+        cacheFile.write( reinterpret_cast<const char*>( &length ), sizeof( uint32_t ) );
+        cacheFile.write( reinterpret_cast<const char*>( currString ), numBytes );
+        cacheFile.write( padding, ( sizeof( uint32_t ) - numBytes % sizeof( uint32_t ) ) % sizeof( uint32_t ) );
+    }
+    cacheFile.write( reinterpret_cast<const char*>( writer.mNodeWords.data() ), sizeof( uint32_t ) * writer.mNodeWords.size() );
+    cacheFile.close();
+    
+    if( !cacheFile || rename( tempFileName.c_str(), cacheFileName.c_str() ) != 0 ) {
+        remove( tempFileName.c_str() );
+    }
+}
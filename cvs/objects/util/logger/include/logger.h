@@ -113,6 +113,7 @@ public:
     virtual void open( const char[] = 0 ) = 0; //!< Pure virtual function called to begin logging.
     int receiveCharFromUnderStream( int ch ); //!< Pure virtual function called to complete the log and clean up.
     virtual void close() = 0;
+    virtual void flush() = 0; //!< Pure virtual function called to write any buffered messages.
     ILogger::WarningLevel setLevel( const ILogger::WarningLevel newLevel );
     bool wouldPrint(ILogger::WarningLevel aLevel) const;
     void toDebugXML( std::ostream& out, Tabs* tabs ) const;
@@ -69,6 +69,8 @@ public:
     static Logger& getLogger( const std::string& aLogName );
     static void toDebugXML( std::ostream& aOut, Tabs* aTabs );
     static void logNewScenarioStarting( const std::string& aScenarioName );
+    static void flushAll();
+    static void redirectAll( const std::string& aFileSuffix );
 private:
     static std::map<std::string,Logger*> mLoggers; //!< Map of logger names to loggers.
     static void XMLParse( const xercesc::DOMNode* aRoot );
@@ -66,6 +66,7 @@ class PlainTextLogger: public Logger {
     public:
     void open( const char[] = 0 );
     void close();
+    void flush();
     void logCompleteMessage( const std::string& aMessage );
 private:
     std::ofstream mLogFile; //!< The filestream to which data is written.
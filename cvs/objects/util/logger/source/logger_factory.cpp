@@ -140,6 +140,36 @@ void LoggerFactory::toDebugXML( ostream& aOut, Tabs* aTabs ) {
 	XMLWriteClosingTag( "LoggerFactory", aOut, aTabs );
 }
 
+/*!
+ * \brief Write any buffered messages of all loggers to their files.
+ * \details This must be called before forking so that the buffered messages
+ *          are not written again by the forked process.
+ */
+void LoggerFactory::flushAll() {
+	for( map<string,Logger*>::const_iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+		logIter->second->flush();
+	}
+}
+
+/*!
+ * \brief Send all loggers to new files named by adding a suffix to their
+ *        current file names, before the extension.
+ * \details This is used by forked workers so that their messages do not get
+ *          mixed into the log files of the parent process.
+ * \param aFileSuffix The suffix to add to each file name.
+ */
+void LoggerFactory::redirectAll( const string& aFileSuffix ) {
+	for( map<string,Logger*>::const_iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+        string& fileName = logIter->second->mFileName;
+        const size_t dirEnd = fileName.find_last_of( "/\\" );
+        const size_t extStart = fileName.find_last_of( '.' );
+        const size_t insertPos = extStart == string::npos || ( dirEnd != string::npos && extStart < dirEnd ) ?
+            fileName.size() : extStart;
+        fileName.insert( insertPos, aFileSuffix );
+        logIter->second->open();
+    }
+}
+
 /*!
  * \brief Log to all configured loggers that the scenario identified by the given scenario
  *        name is starting.
@@ -59,6 +59,11 @@ void PlainTextLogger::open( const char[] ){
         mFileName = "log.txt";
     }
 
+    // A file which is already open is left without completing it, such as the
+    // log of the parent process when redirected by a forked worker.
+    if( mLogFile.is_open() ) {
+        mLogFile.close();
+    }
     mLogFile.open( mFileName.c_str(), ios::out );
 
     // Print the header message
@@ -73,6 +78,11 @@ void PlainTextLogger::close(){
     mLogFile.close();
 }
 
+//! Writes any buffered messages to the file.
+void PlainTextLogger::flush(){
+    mLogFile.flush();
+}
+
 //! Logs a single message.
 void PlainTextLogger::logCompleteMessage( const string& aMessage ){
     // Decide whether to print the message
@@ -62,6 +62,11 @@ void XMLLogger::open( const char[] ){
 		mFileName = "log.xml";
 	}
 
+    // A file which is already open is left without completing it, such as the
+    // log of the parent process when redirected by a forked worker.
+    if( mLogFile.is_open() ) {
+        mLogFile.close();
+    }
     mLogFile.open( mFileName.c_str(), ios::out );
 
 	// Print the header message
@@ -78,6 +83,11 @@ void XMLLogger::close(){
 	mLogFile.close();
 }
 
+//! Writes any buffered messages to the file.
+void XMLLogger::flush(){
+	mLogFile.flush();
+}
+
 //! Logs a single message.
 void XMLLogger::logCompleteMessage( const string& aMessage ){
 	// Decide whether to print the message